@@ -4,7 +4,7 @@
 
 namespace App {
 
-enum class SourceType { Serial, Udp, Simulator };
+enum class SourceType { Serial, Udp, Simulator, TcpClient, Replay };
 
 struct DataSourceConfig {
     std::string id;
@@ -17,10 +17,29 @@ struct DataSourceConfig {
     int baudRate = 4800;
 
     // Network
+    std::string address = "127.0.0.1"; // TCP client: gateway host name or IP
     int port = 10110;
+
+    // UDP, empty addresses mean "any"
+    std::string multicastGroup;
+    std::string interfaceAddress; // Multicast join interface, or bound address
+    std::string sourceFilter;     // Only accept datagrams sent from this address
+    bool sharedPort = false;      // Let other programs bind the port too
+    int udpReceivers = 1;         // Sockets spreading the peers of a unicast, unshared port
+
+    // Replay: recording directory, segment (.nvr) or NMEA text log
+    std::string replayPath;
+    double replaySpeed = 1.0; // 0: as fast as possible
+    bool replayLoop = false;
 };
 
-enum class OutputType { Serial, Udp };
+enum class OutputType { Serial, Udp, TcpServer };
+
+// Sentence patterns match the address field: "GPRMC", "*RMC" (any talker), "GP*" (any formatter)
+struct SentenceRateLimit {
+    std::string sentence;
+    int intervalMs = 1000; // At most one matching sentence per interval
+};
 
 struct DataOutputConfig {
     std::string id;
@@ -35,10 +54,20 @@ struct DataOutputConfig {
     // Network
     std::string address = "127.0.0.1";
     int port = 10110;
+    bool coalesce = false;       // Pack several sentences per datagram
+    int maxDatagramSize = 1400;  // Bytes, below the path MTU
+    int flushDelayMs = 5;        // Max wait of a sentence in a partial datagram
+    int maxClients = 16;         // TCP server
 
     // Multiplexing
     bool multiplexAll = true;
     std::vector<std::string> sourceIds;
+
+    // Filtering, applied after multiplexing
+    std::vector<std::string> allowSentences; // Empty: everything not denied
+    std::vector<std::string> denySentences;
+    std::vector<SentenceRateLimit> rateLimits;
+    double aisRangeNm = 0.0;                 // Forward AIS targets within this range only, 0: no limit
 };
 
 struct DisplayConfig {
@@ -46,4 +75,12 @@ struct DisplayConfig {
     int theme = 0; // 0: Dark, 1: Light, 2: Classic
 };
 
+// Raw sentence recording (Recorder)
+struct RecordingConfig {
+    bool enabled = false;
+    std::string directory = "recordings";
+    int segmentSizeMB = 64;  // A new segment file past this size...
+    int segmentMinutes = 60; // ...or this duration
+};
+
 } // namespace App
@@ -6,6 +6,9 @@
 #include "simulator/WaterSimulator.hpp"
 #include "simulator/AisSimulator.hpp"
 #include "utils/ConfigManager.hpp"
+#include "core/VesselStateStore.hpp"
+#include "core/AisTargetStore.hpp"
+#include "core/TimerScheduler.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -30,9 +33,13 @@ NavOneApp::NavOneApp(Core::ThreadPool& pool, bool headlessMode)
       _simulatorWindow(*_simulator) {
     
     // Setup Service Manager Logging
-    _serviceManager.setLogCallback([this](const std::string& source, const std::string& frame) {
+    _serviceManager.setLogCallback([this](const std::string& source, std::string_view frame) {
         if (_headless) {
-            std::cout << "[" << source << "] " << frame << std::endl;
+            // Called concurrently from the I/O threads: one insertion per line
+            std::string line;
+            line.reserve(source.size() + frame.size() + 4);
+            line.append("[").append(source).append("] ").append(frame).append("\n");
+            std::cout << line << std::flush;
         } else {
             _monitorWindow.addLog(source, frame);
         }
@@ -44,92 +51,59 @@ NavOneApp::NavOneApp(Core::ThreadPool& pool, bool headlessMode)
     // Apply Simulator Config
     _simulator->setConfig(Utils::ConfigManager::instance().getSimulatorConfig());
     
-    // Subscribe to MessageBus
-    _busListenerId = Core::MessageBus::instance().subscribe([this](const Core::NavData& update) {
-        {
-            std::lock_guard<std::mutex> lock(_dataMutex);
-            // Merge logic to persist data across partial updates
-            _currentData.timestamp = update.timestamp;
-            _currentData.sourceId = update.sourceId;
-
-            if (update.hasPosition) {
-                _currentData.latitude = update.latitude;
-                _currentData.longitude = update.longitude;
-                _currentData.altitude = update.altitude;
-                _currentData.isGpsValid = update.isGpsValid;
-                _currentData.hasPosition = true;
-            }
-            
-            if (update.hasSpeed) {
-                _currentData.speedOverGround = update.speedOverGround;
-                _currentData.courseOverGround = update.courseOverGround;
-                _currentData.hasSpeed = true;
-            }
-            
-            if (update.hasHeading) {
-                _currentData.heading = update.heading;
-                _currentData.hasHeading = true;
-            }
-            
-            if (update.hasWind) {
-                _currentData.windSpeed = update.windSpeed;
-                _currentData.windAngle = update.windAngle;
-                _currentData.hasWind = true;
-            }
-            
-            if (update.hasDepth) {
-                _currentData.depth = update.depth;
-                _currentData.hasDepth = true;
-            }
-
-            if (update.hasWaterTemperature) {
-                _currentData.waterTemperature = update.waterTemperature;
-                _currentData.hasWaterTemperature = true;
-            }
+    // Fused vessel state: merged on the publishing thread, cheap and never blocked by readers
+    _stateListenerId = Core::MessageBus::instance().subscribe([](const Core::CompactNavData& update) {
+        Core::VesselStateStore::instance().merge(update);
+    });
 
-            if (update.hasWaterSpeed) {
-                _currentData.speedThroughWater = update.speedThroughWater;
-                _currentData.hasWaterSpeed = true;
-            }
-        }
+    // Dashboard statistics are drained on the pool, so its lock never delays publishers
+    _busListenerId = Core::MessageBus::instance().subscribeAsync([this](const Core::CompactNavData& update) {
         _dashboardWindow.updateData(update);
-    });
+    }, _threadPool);
 
-    // Start a background task to simulate data acquisition (publishing to bus)
-    _threadPool.enqueue([this] {
-        while(_running) {
-            if (_isSimulatorActive) {
-                // Update Simulator Physics (100ms step)
-                _simulator->update(0.1);
-                
-                // Only publish if Simulator is enabled as a Source in ServiceManager
-                if (_serviceManager.isSourceEnabled("SIMULATOR")) {
-                    // Get Data
-                    Core::NavData simData = _simulator->getCurrentData();
-                    
-                    // Log simulated frames
-                    auto sentences = _simulator->getNmeaSentences();
-                    for (const auto& sentence : sentences) {
-                        _monitorWindow.addLog("SIMULATOR", sentence);
-                        // Broadcast to outputs
-                        _serviceManager.broadcast(sentence + "\r\n", "SIMULATOR");
-                    }
-
-                    Core::MessageBus::instance().publish(simData);
-                }
-            }
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+    // Simulate data acquisition (publishing to bus) on the shared timer thread
+    _simulatorTimer = Core::TimerScheduler::instance().schedulePeriodic(std::chrono::milliseconds(100), [this] {
+        simulatorTick();
     });
+
+    // Bounds the AIS target table in long runs: vessels out of range are forgotten
+    _aisExpiryTimer = Core::TimerScheduler::instance().schedulePeriodic(Core::AisTargetStore::ExpiryPeriod, [] {
+        Core::AisTargetStore::instance().expire(std::chrono::system_clock::now() - Core::AisTargetStore::MaxTargetAge);
+    }, std::chrono::seconds(5));
 }
 
 NavOneApp::~NavOneApp() {
     _running = false;
+    Core::TimerScheduler::instance().cancel(_simulatorTimer);
+    Core::TimerScheduler::instance().cancel(_aisExpiryTimer);
     Core::MessageBus::instance().unsubscribe(_busListenerId);
+    Core::MessageBus::instance().unsubscribe(_stateListenerId);
     _serviceManager.stopAll();
 }
 
+void NavOneApp::simulatorTick() {
+    if (!_isSimulatorActive) return;
+
+    // Update Simulator Physics (100ms step)
+    _simulator->update(0.1);
+
+    // Only publish if Simulator is enabled as a Source in ServiceManager
+    if (_serviceManager.isSourceEnabled("SIMULATOR")) {
+        // Get Data
+        Core::NavData simData = _simulator->getCurrentData();
+
+        // Log simulated frames
+        auto sentences = _simulator->getNmeaSentences();
+        for (const auto& sentence : sentences) {
+            _monitorWindow.addLog("SIMULATOR", sentence);
+            // Broadcast to outputs
+            _serviceManager.broadcast(Core::SentenceRef::make(sentence), _simulatorSource);
+        }
+
+        Core::MessageBus::instance().publish(simData);
+    }
+}
+
 bool NavOneApp::init() {
     if (!_headless) {
         if (!Gui::MainWindow::init()) return false;
@@ -153,13 +127,41 @@ void NavOneApp::runHeadless() {
     std::cout << "NavOne running in headless mode." << std::endl;
     std::cout << "Press Ctrl+C to exit." << std::endl;
     
-    while (_running) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    // Periodic summary of the fused state
+    uint64_t lastVersion = 0;
+    auto reportTimer = Core::TimerScheduler::instance().schedulePeriodic(std::chrono::seconds(10), [&lastVersion] {
+        auto& state = Core::VesselStateStore::instance();
+        if (state.version() == lastVersion) return;
+        lastVersion = state.version();
+
+        Core::CompactNavData data = state.snapshot();
+        std::cout << "[STATE] " << std::fixed << std::setprecision(5);
+        if (data.has(Core::NavField::Position)) std::cout << "pos " << data.latitude << " " << data.longitude << " ";
+        std::cout << std::setprecision(1);
+        if (data.has(Core::NavField::Speed)) std::cout << "sog " << data.speedOverGround << " cog " << data.courseOverGround << " ";
+        if (data.has(Core::NavField::Heading)) std::cout << "hdg " << data.heading << " ";
+        if (data.has(Core::NavField::Wind)) std::cout << "wind " << data.windSpeed << "@" << data.windAngle << " ";
+        if (data.has(Core::NavField::Depth)) std::cout << "depth " << data.depth << " ";
+        std::cout << std::endl;
+    }, std::chrono::seconds(1));
+
+    // A signal handler can't notify a waiting thread: requestStop() is polled from here
+    auto stopTimer = Core::TimerScheduler::instance().schedulePeriodic(std::chrono::milliseconds(100), [this] {
+        if (s_stopRequested.exchange(false, std::memory_order_relaxed)) {
+            std::cout << "Interrupt received, stopping." << std::endl;
+            stop();
+        }
+    }, std::chrono::milliseconds(50));
+
+    // Sleep until stop()
+    _running.wait(true);
+    Core::TimerScheduler::instance().cancel(stopTimer);
+    Core::TimerScheduler::instance().cancel(reportTimer);
 }
 
 void NavOneApp::stop() {
     _running = false;
+    _running.notify_all();
 }
 
 void NavOneApp::render() {
@@ -245,11 +247,8 @@ void NavOneApp::render() {
     _monitorWindow.render();
     _dashboardWindow.render(_threadPool, _serviceManager);
     
-    // Render Plugins
-    {
-        std::lock_guard<std::mutex> lock(_dataMutex);
-        _pluginManager.renderPlugins(_currentData);
-    }
+    // Render Plugins (plugin API takes the legacy NavData)
+    _pluginManager.renderPlugins(Core::VesselStateStore::instance().snapshot().toNavData());
 }
 
 } // namespace App
@@ -3,6 +3,8 @@
 #include "gui/MainWindow.hpp"
 #include "core/ThreadPool.hpp"
 #include "core/MessageBus.hpp"
+#include "core/TimerScheduler.hpp"
+#include "core/SourceRegistry.hpp"
 #include "app/services/ServiceManager.hpp"
 #include "gui/windows/NmeaMonitorWindow.hpp"
 #include "gui/windows/DashboardWindow.hpp"
@@ -27,13 +29,20 @@ public:
     void render() override;
     void stop();
 
+    // Async-signal-safe (SIGINT handler): only raises a flag, turned into stop() by a timer task
+    static void requestStop() { s_stopRequested.store(true, std::memory_order_relaxed); }
+
 private:
     void runHeadless();
+    void simulatorTick();
 
     Core::ThreadPool& _threadPool;
     bool _headless;
     std::atomic<bool> _running{true};
+    static inline std::atomic<bool> s_stopRequested{false};
+    static_assert(std::atomic<bool>::is_always_lock_free, "requestStop() must be usable from a signal handler");
     Core::MessageBus::ListenerId _busListenerId;
+    Core::MessageBus::ListenerId _stateListenerId;
     
     // Managers
     ServiceManager _serviceManager;
@@ -42,6 +51,9 @@ private:
     // Simulator (Must be declared before SimulatorWindow)
     std::unique_ptr<Simulator::ISimulator> _simulator;
     std::atomic<bool> _isSimulatorActive{false};
+    Core::SourceHandle _simulatorSource = Core::SourceRegistry::instance().intern("SIMULATOR"); // Routing key
+    Core::TimerScheduler::TimerId _simulatorTimer = Core::TimerScheduler::InvalidTimer;
+    Core::TimerScheduler::TimerId _aisExpiryTimer = Core::TimerScheduler::InvalidTimer;
 
     // Windows
     Gui::NmeaMonitorWindow _monitorWindow;
@@ -50,10 +62,6 @@ private:
     Gui::DisplaySettingsWindow _displaySettingsWindow;
     Gui::SimulatorWindow _simulatorWindow;
     Gui::AboutWindow _aboutWindow;
-    
-    // Data
-    std::mutex _dataMutex;
-    Core::NavData _currentData;
 };
 
 } // namespace App
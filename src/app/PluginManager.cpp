@@ -1,5 +1,7 @@
 #include "PluginManager.hpp"
+#include "parsers/NmeaParser.hpp"
 #include "imgui.h"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 
@@ -83,6 +85,12 @@ void PluginManager::loadPlugin(const std::string& path) {
     // Initialize Plugin
     PluginApi::PluginContext ctx;
     ctx.imguiContext = ImGui::GetCurrentContext();
+    ctx.registerSentenceHandler = [](const char* formatter, PluginApi::SentenceHandlerFunc handler) {
+        return formatter && Parsers::NmeaParser::registerHandler(formatter, handler);
+    };
+    ctx.unregisterSentenceHandler = [](const char* formatter) {
+        if (formatter) Parsers::NmeaParser::unregisterHandler(formatter);
+    };
     instance->init(ctx);
 
     LoadedPlugin plugin;
@@ -97,11 +105,13 @@ void PluginManager::loadPlugin(const std::string& path) {
 }
 
 void PluginManager::unloadPlugin(const std::string& path) {
-    auto it = std::find_if(_plugins.begin(), _plugins.end(), 
+    auto it = std::find_if(_plugins.begin(), _plugins.end(),
         [&path](const LoadedPlugin& p) { return p.path == path; });
 
     if (it != _plugins.end()) {
         if (it->instance) {
+            // Unregistering its sentence handlers waits for the I/O threads running them,
+            // so the library can be closed afterwards
             it->instance->shutdown();
             it->destroyFunc(it->instance);
         }
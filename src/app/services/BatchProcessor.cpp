@@ -0,0 +1,503 @@
+#include "BatchProcessor.hpp"
+#include "core/RecordingFormat.hpp"
+#include "parsers/NmeaChecksum.hpp"
+#include "parsers/NmeaParser.hpp"
+#include "utils/ReplayLog.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+
+namespace App {
+
+namespace {
+
+using Utils::ReplayLog;
+namespace fs = std::filesystem;
+
+constexpr int64_t DayNs = ReplayLog::DayNs;
+constexpr size_t ProbeBytes = 1024 * 1024;
+
+int64_t toEpochNs(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+bool readSegmentHeader(const std::string& path, Core::Recording::SegmentHeader& header) {
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return file && Core::Recording::hasMagic(header.magic, Core::Recording::SegmentMagic);
+}
+
+// Epoch time of the start of an input: segment open time, or first dated RMC in the
+// first megabyte of a text log
+std::optional<int64_t> probeStart(const std::string& path) {
+    Core::Recording::SegmentHeader header;
+    if (readSegmentHeader(path, header)) return header.wallClockNs;
+
+    Utils::MappedFile file(path);
+    std::string_view text = file.view().substr(0, ProbeBytes);
+    for (size_t pos = 0; pos < text.size();) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view sentence = ReplayLog::lineSentence(text.substr(pos, eol - pos));
+        pos = eol + 1;
+
+        Core::NavData data;
+        if (sentence.find("RMC,") != std::string_view::npos && Parsers::NmeaParser::parse(sentence, data, false) &&
+            data.timestamp != std::chrono::system_clock::time_point{}) {
+            return toEpochNs(data.timestamp);
+        }
+    }
+    return std::nullopt;
+}
+
+// Fixed point, as printf("%.*f") for the magnitudes of navigation data, without its cost:
+// rows are written by the single merging thread
+void appendFixed(std::string& out, double value, int decimals) {
+    static constexpr int64_t Scale[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    if (!std::isfinite(value) || std::fabs(value) >= 1e11) {
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        out += buffer;
+        return;
+    }
+
+    int64_t scaled = std::llround(std::fabs(value) * Scale[decimals]);
+    if (value < 0 && scaled != 0) out += '-';
+
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), scaled / Scale[decimals]);
+    out.append(buffer, result.ptr);
+    if (decimals == 0) return;
+
+    out += '.';
+    int64_t fraction = scaled % Scale[decimals];
+    result = std::to_chars(buffer, buffer + sizeof(buffer), fraction);
+    out.append(decimals - (result.ptr - buffer), '0');
+    out.append(buffer, result.ptr);
+}
+
+// "2024-06-01T12:30:05.250Z" for epoch times, "12:30:05.250" (time of day) otherwise
+void appendTime(std::string& out, int64_t timeNs, bool dated) {
+    int64_t days = timeNs / DayNs;
+    int64_t ms = (timeNs % DayNs) / 1000000;
+    char buffer[40];
+
+    if (!dated) {
+        std::snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d.%03d", static_cast<int>(ms / 3600000),
+                      static_cast<int>(ms / 60000 % 60), static_cast<int>(ms / 1000 % 60), static_cast<int>(ms % 1000));
+        out += buffer;
+        return;
+    }
+
+    // Civil date from days since 1970-01-01 (proleptic Gregorian calendar)
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    int year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", year, month, day,
+                  static_cast<int>(ms / 3600000), static_cast<int>(ms / 60000 % 60), static_cast<int>(ms / 1000 % 60),
+                  static_cast<int>(ms % 1000));
+    out += buffer;
+}
+
+} // namespace
+
+BatchProcessor::BatchProcessor(Core::ThreadPool& pool, Options options)
+    : _pool(pool), _options(std::move(options)), _intervalNs(std::max<int64_t>(_options.intervalMs, 0) * 1000000) {}
+
+BatchProcessor::Summary BatchProcessor::run() {
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<std::string> inputs = listInputs();
+    if (inputs.empty()) throw std::runtime_error("No input files");
+
+    // Season of logs given in any order: merged by time, if they all tell it
+    std::vector<std::pair<int64_t, std::string>> ordered;
+    for (const auto& input : inputs) {
+        auto start = probeStart(input);
+        if (!start) break;
+        ordered.emplace_back(*start, input);
+    }
+    const bool merge = ordered.size() == inputs.size();
+    if (merge) {
+        std::stable_sort(ordered.begin(), ordered.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (size_t i = 0; i < ordered.size(); ++i) inputs[i] = ordered[i].second;
+    }
+
+    std::vector<size_t> firstChunks;
+    for (const auto& input : inputs) {
+        firstChunks.push_back(_chunks.size());
+        planInput(input);
+    }
+    firstChunks.push_back(_chunks.size());
+    _summary.files = inputs.size();
+    _summary.chunks = _chunks.size();
+
+    std::vector<Stream> streams(merge ? inputs.size() : 1);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        Stream& stream = streams[merge ? i : 0];
+        for (size_t chunk = firstChunks[i]; chunk < firstChunks[i + 1]; ++chunk) stream.chunks.push_back(&_chunks[chunk]);
+        if (merge) stream.startNs = ordered[i].first;
+    }
+
+    std::error_code ec;
+    fs::create_directories(_options.outputDirectory, ec);
+    fs::path directory(_options.outputDirectory);
+    _csv.open(directory / "track.csv");
+    _gpx.open(directory / "track.gpx");
+    if (!_csv || !_gpx) throw std::runtime_error("Cannot write to " + _options.outputDirectory);
+
+    _csv << "time,latitude,longitude,sog_kn,cog_deg,heading_deg,stw_kn,depth_m,water_temp_c,wind_speed_kn,wind_angle_deg,gps_valid\n";
+    _gpx << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         << "<gpx version=\"1.1\" creator=\"NavOne\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+         << "<trk><name>NavOne</name><trkseg>\n";
+
+    // Chunks complete out of order but are merged in order; the window, shared by the
+    // streams being merged, bounds memory. A stream joins once the merge reaches its start.
+    _maxInFlight = std::max<size_t>(_pool.getThreadCount(), 1) * 2;
+    auto ahead = [this](size_t streamCount) { return std::max<size_t>(1, _maxInFlight / std::max<size_t>(streamCount, 1)); };
+    std::vector<Stream*> active;
+    size_t nextStream = 0;
+    try {
+        for (;;) {
+            Stream* earliest = nullptr;
+            for (Stream* stream : active) {
+                if (!earliest || headTime(*stream) < headTime(*earliest)) earliest = stream;
+            }
+
+            if (nextStream < streams.size() &&
+                (!earliest || !streams[nextStream].startNs || *streams[nextStream].startNs <= headTime(*earliest))) {
+                Stream& stream = streams[nextStream++];
+                if (loadChunk(stream, ahead(active.size() + 1))) active.push_back(&stream);
+                continue;
+            }
+            if (!earliest) break;
+
+            mergeSample(*earliest);
+            if (++earliest->sample == earliest->current.samples.size() && !loadChunk(*earliest, ahead(active.size()))) {
+                active.erase(std::find(active.begin(), active.end(), earliest));
+            }
+        }
+    } catch (...) {
+        // Queued chunks refer to this and to _chunks: let them finish before unwinding
+        for (auto& stream : streams) {
+            for (auto& result : stream.inFlight) {
+                if (result.valid()) result.wait();
+            }
+        }
+        throw;
+    }
+    if (_hasRow) writeRow();
+
+    _gpx << "</trkseg></trk>\n</gpx>\n";
+    _csv.close();
+    _gpx.close();
+
+    std::ofstream sentences(directory / "sentences.csv");
+    sentences << "sentence,count,bytes,checksum_errors,parsed,share_pct\n";
+    for (const auto& [address, count] : _sentences) {
+        char line[160];
+        std::snprintf(line, sizeof(line), ",%llu,%llu,%llu,%llu,%.3f\n", static_cast<unsigned long long>(count.count),
+                      static_cast<unsigned long long>(count.bytes), static_cast<unsigned long long>(count.checksumErrors),
+                      static_cast<unsigned long long>(count.parsed),
+                      _summary.sentences ? 100.0 * count.count / _summary.sentences : 0.0);
+        sentences << address << line;
+    }
+    sentences.close();
+
+    if (_csv.fail() || _gpx.fail() || sentences.fail()) {
+        throw std::runtime_error("Failed writing the outputs to " + _options.outputDirectory);
+    }
+
+    _summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return _summary;
+}
+
+std::vector<std::string> BatchProcessor::listInputs() const {
+    std::vector<std::string> inputs;
+    for (const auto& input : _options.inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            // Every file of the directory, in name order (recording segments sort by time)
+            std::vector<std::string> files;
+            for (const auto& item : fs::directory_iterator(input, ec)) {
+                if (item.is_regular_file()) files.push_back(item.path().string());
+            }
+            std::sort(files.begin(), files.end());
+            inputs.insert(inputs.end(), files.begin(), files.end());
+        } else if (fs::is_regular_file(input, ec)) {
+            inputs.push_back(input);
+        } else {
+            throw std::runtime_error("Cannot read " + input);
+        }
+    }
+    return inputs;
+}
+
+void BatchProcessor::planInput(const std::string& path) {
+    Core::Recording::SegmentHeader header;
+    if (readSegmentHeader(path, header)) {
+        _chunks.push_back(Chunk{nullptr, path, 0, 0});
+        return;
+    }
+
+    // Cut after the first line end past each chunkBytes step
+    const Utils::MappedFile& file = _files.emplace_back(path);
+    std::string_view text = file.view();
+    const size_t step = std::max<size_t>(_options.chunkBytes, 4096);
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = std::min(begin + step, text.size());
+        if (end < text.size()) {
+            size_t eol = text.find('\n', end - 1);
+            end = eol == std::string_view::npos ? text.size() : eol + 1;
+        }
+        _chunks.push_back(Chunk{&file, path, begin, end});
+        begin = end;
+    }
+}
+
+BatchProcessor::ChunkResult BatchProcessor::processChunk(const Chunk& chunk) const {
+    ChunkState state;
+
+    if (chunk.text) {
+        std::string_view text = chunk.text->view().substr(chunk.begin, chunk.end - chunk.begin);
+        for (size_t pos = 0; pos < text.size();) {
+            size_t eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) eol = text.size();
+            std::string_view sentence = ReplayLog::lineSentence(text.substr(pos, eol - pos));
+            pos = eol + 1;
+            if (!sentence.empty()) processSentence(sentence, -1, state);
+        }
+    } else {
+        // Receive times are epoch times already
+        state.result.dated = true;
+        try {
+            auto log = std::make_shared<const ReplayLog>(chunk.path);
+            ReplayLog::Cursor cursor(*log);
+            ReplayLog::Entry entry;
+            while (cursor.next(entry)) processSentence(entry.sentence, entry.timeNs, state);
+            state.result.recording = std::move(log);
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping " << chunk.path << ": " << e.what() << std::endl;
+            state.result.sentences.clear(); // Views into the discarded mapping
+            state.result.samples.clear();
+            state.result.timed = false;
+            state.pending = false;
+        }
+    }
+
+    flushSample(state);
+    return std::move(state.result);
+}
+
+void BatchProcessor::processSentence(std::string_view sentence, int64_t recordedNs, ChunkState& state) const {
+    ChunkResult& result = state.result;
+
+    size_t end = sentence.find_first_of(",*");
+    SentenceCount& count = result.sentences[sentence.substr(1, end == std::string_view::npos ? end : end - 1)];
+    count.count++;
+    count.bytes += sentence.size();
+
+    if (!Parsers::NmeaChecksum::verify(sentence)) {
+        count.checksumErrors++;
+        return;
+    }
+
+    // Time line of the chunk, never going back
+    int64_t timeOfDay;
+    bool timed = recordedNs >= 0 || ReplayLog::sentenceTime(sentence, timeOfDay);
+    if (timed) {
+        if (recordedNs >= 0) {
+            state.timeNs = std::max(state.timeNs, recordedNs);
+        } else {
+            state.timeNs = state.timeNs < 0 ? timeOfDay : ReplayLog::followTime(state.timeNs, timeOfDay);
+        }
+        if (!result.timed) result.firstNs = state.timeNs;
+        result.timed = true;
+        result.lastNs = state.timeNs;
+    }
+
+    if (sentence[0] != '$') return; // AIS: counted only
+
+    Core::NavData data;
+    if (!Parsers::NmeaParser::parse(sentence, data, false)) return;
+    count.parsed++;
+
+    // First dated RMC: chunk time 0 is the midnight before it
+    if (!result.dated && data.timestamp != std::chrono::system_clock::time_point{} && state.timeNs >= 0) {
+        int64_t midnight = toEpochNs(data.timestamp) - state.timeNs;
+        result.baseNs = (midnight + DayNs / 2) / DayNs * DayNs;
+        result.dated = true;
+    }
+
+    Core::CompactNavData update = Core::CompactNavData::fromNavData(data);
+    if (update.fields == 0) return;
+    update.timestampNs = state.timeNs;
+
+    if (state.pending && (_intervalNs == 0 || (state.timeNs >= 0 && state.timeNs / _intervalNs != state.slot))) {
+        flushSample(state);
+    }
+    if (state.timeNs >= 0 && _intervalNs > 0) state.slot = state.timeNs / _intervalNs;
+    state.partial.merge(update);
+    state.updated |= update.fields;
+    state.pending = true;
+}
+
+void BatchProcessor::flushSample(ChunkState& state) {
+    if (!state.pending) return;
+    state.result.samples.push_back(Sample{state.partial.timestampNs, state.partial, state.updated});
+    state.updated = 0;
+    state.pending = false;
+}
+
+void BatchProcessor::submitChunks(Stream& stream, size_t ahead) {
+    while (stream.inFlight.size() < ahead && stream.submitted < stream.chunks.size()) {
+        const Chunk* chunk = stream.chunks[stream.submitted++];
+        stream.inFlight.push_back(_pool.enqueue([this, chunk]() { return processChunk(*chunk); }));
+    }
+}
+
+bool BatchProcessor::loadChunk(Stream& stream, size_t ahead) {
+    for (;;) {
+        submitChunks(stream, ahead);
+        if (stream.inFlight.empty()) return false;
+
+        const size_t index = stream.submitted - stream.inFlight.size();
+        ChunkResult result = stream.inFlight.front().get();
+        stream.inFlight.pop_front();
+        submitChunks(stream, ahead);
+        countSentences(result);
+
+        // Undated text: continues the previous chunk, on the same day or past midnight
+        int64_t baseNs = result.baseNs;
+        bool dated = result.dated;
+        if (!dated && result.timed && stream.endNs >= 0) {
+            baseNs = stream.endNs / DayNs * DayNs;
+            if (baseNs + result.firstNs < stream.endNs - DayNs / 2) baseNs += DayNs;
+            dated = stream.endDated;
+        }
+
+        // Only concatenated inputs can go back in time from one input to the next
+        const std::string& path = stream.chunks[index]->path;
+        if (dated && result.timed && stream.endNs >= 0 && baseNs + result.firstNs < stream.endNs &&
+            index > 0 && stream.chunks[index - 1]->path != path) {
+            std::cerr << "Warning: " << path << " starts before the end of the previous input. Not every input "
+                      << "is dated, so they are concatenated in the given order, not merged by time" << std::endl;
+        }
+
+        stream.untimedNs = stream.endNs >= 0 ? stream.endNs : (result.timed ? baseNs + result.firstNs : 0);
+        if (result.timed) {
+            stream.endNs = baseNs + result.lastNs;
+            stream.endDated = dated;
+        }
+        stream.baseNs = baseNs;
+        stream.dated = dated;
+        stream.start = stream.state;
+        stream.current = std::move(result);
+        stream.sample = 0;
+        if (!stream.current.samples.empty()) return true;
+    }
+}
+
+void BatchProcessor::countSentences(const ChunkResult& result) {
+    for (const auto& [address, count] : result.sentences) {
+        SentenceCount& total = _sentences[std::string(address)];
+        total.count += count.count;
+        total.bytes += count.bytes;
+        total.checksumErrors += count.checksumErrors;
+        total.parsed += count.parsed;
+        _summary.sentences += count.count;
+        _summary.bytes += count.bytes;
+        _summary.checksumErrors += count.checksumErrors;
+        _summary.parsed += count.parsed;
+    }
+}
+
+int64_t BatchProcessor::headTime(const Stream& stream) {
+    const Sample& sample = stream.current.samples[stream.sample];
+    return sample.timeNs >= 0 ? stream.baseNs + sample.timeNs : stream.untimedNs;
+}
+
+void BatchProcessor::mergeSample(Stream& stream) {
+    // Partial state of the chunk, completed by the state it starts from
+    const Sample& sample = stream.current.samples[stream.sample];
+    const int64_t timeNs = headTime(stream);
+    stream.state = stream.start;
+    stream.state.merge(sample.state);
+    stream.state.timestampNs = timeNs;
+
+    // Only the fields of this sample: other streams may have updated the others since
+    Core::CompactNavData update = stream.state;
+    update.fields = sample.fields;
+    _state.merge(update);
+    holdRow(timeNs, _state, stream.dated);
+}
+
+void BatchProcessor::holdRow(int64_t timeNs, const Core::CompactNavData& state, bool dated) {
+    // Same interval: the later state replaces the held one (chunk boundaries split intervals)
+    if (_hasRow && !(_intervalNs > 0 && timeNs / _intervalNs == _rowNs / _intervalNs)) writeRow();
+    _row = state;
+    _rowNs = timeNs;
+    _rowDated = dated;
+    _hasRow = true;
+}
+
+void BatchProcessor::writeRow() {
+    using namespace Core::NavField;
+
+    // Empty cells for data not received yet
+    std::string& line = _line;
+    line.clear();
+    appendTime(line, _rowNs, _rowDated);
+    const size_t timeLength = line.size();
+    auto cell = [&line](bool present, double value, int decimals) {
+        line += ',';
+        if (present) appendFixed(line, value, decimals);
+    };
+    cell(_row.has(Position), _row.latitude, 7);
+    cell(_row.has(Position), _row.longitude, 7);
+    cell(_row.has(Speed), _row.speedOverGround, 2);
+    cell(_row.has(Speed), _row.courseOverGround, 1);
+    cell(_row.has(Heading), _row.heading, 1);
+    cell(_row.has(WaterSpeed), _row.speedThroughWater, 2);
+    cell(_row.has(Depth), _row.depth, 1);
+    cell(_row.has(WaterTemperature), _row.waterTemperature, 1);
+    cell(_row.has(Wind), _row.windSpeed, 1);
+    cell(_row.has(Wind), _row.windAngle, 1);
+    line += _row.has(Position) ? (_row.isGpsValid ? ",1\n" : ",0\n") : ",\n";
+    _csv.write(line.data(), line.size());
+    _summary.trackPoints++;
+
+    if (_row.has(Position) && _row.isGpsValid) {
+        std::string_view time(line.data(), timeLength);
+        std::string& point = _point;
+        point = "<trkpt lat=\"";
+        appendFixed(point, _row.latitude, 7);
+        point += "\" lon=\"";
+        appendFixed(point, _row.longitude, 7);
+        point += "\">";
+        if (_rowDated) {
+            point += "<time>";
+            point += time;
+            point += "</time>";
+        }
+        point += "</trkpt>\n";
+        _gpx.write(point.data(), point.size());
+    }
+    _hasRow = false;
+}
+
+} // namespace App
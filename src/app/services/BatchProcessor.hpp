@@ -0,0 +1,168 @@
+#pragma once
+
+#include "core/CompactNavData.hpp"
+#include "core/ThreadPool.hpp"
+#include "utils/MappedFile.hpp"
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Utils { class ReplayLog; }
+
+namespace App {
+
+// Offline processing of logs (-batch): every sentence goes through the parser and the
+// fusion (CompactNavData::merge) as fast as the cores allow, and the results are written as
+// files instead of being routed.
+//
+// Text logs are cut into chunks at line boundaries and recording segments are chunks of
+// their own. Chunks are parsed in parallel on the thread pool, each fusing its updates from
+// an empty state. They are then chained back in log order, the state at the end of a chunk
+// completing the partial states of the next one: the output is the one of a sequential pass.
+//
+// When every input has a dated sentence, inputs are merged by time (k-way merge of their
+// samples): overlapping logs, e.g. from two receivers on the same trip, interleave, each
+// sample bringing the fields it updated into the fused state. Otherwise inputs are
+// concatenated in the given order, undated ones continuing the previous one, and an input
+// going back in time is reported.
+//
+// Outputs, in the output directory:
+//   track.csv      fused state, at most one row per interval of log time
+//   track.gpx      valid GPS positions of the same rows
+//   sentences.csv  counters per sentence address (e.g. "GPRMC")
+class BatchProcessor {
+public:
+    struct Options {
+        std::vector<std::string> inputs;    // Text logs, recordings (.nvr), or directories of them
+        std::string outputDirectory = ".";
+        int64_t intervalMs = 1000;          // Track resolution, 0: a row per update
+        size_t chunkBytes = 8 * 1024 * 1024; // Text logs are split into chunks of about this size
+    };
+
+    struct Summary {
+        size_t files = 0;
+        size_t chunks = 0;
+        uint64_t sentences = 0;
+        uint64_t bytes = 0;
+        uint64_t checksumErrors = 0;
+        uint64_t parsed = 0;      // Sentences decoded into navigation data
+        uint64_t trackPoints = 0; // Rows of track.csv
+        double seconds = 0.0;
+    };
+
+    BatchProcessor(Core::ThreadPool& pool, Options options);
+
+    // Throws std::runtime_error if an input can't be read or an output can't be written
+    Summary run();
+
+private:
+    struct SentenceCount {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+        uint64_t checksumErrors = 0;
+        uint64_t parsed = 0;
+    };
+
+    // Part of an input processed by one task: a line range of a text log, or a segment
+    struct Chunk {
+        const Utils::MappedFile* text = nullptr; // Null: recording segment 'path'
+        std::string path;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // Fused state since the start of its chunk, as of 'timeNs'
+    struct Sample {
+        int64_t timeNs; // Chunk time (see ChunkResult), -1 before the first timed sentence
+        Core::CompactNavData state;
+        Core::NavFieldMask fields; // Updated since the previous sample
+    };
+
+    // Chunk time runs from midnight of the first day seen in the chunk for text logs, and
+    // is the epoch time for recordings. 'dated' once a date maps it to epoch time.
+    struct ChunkResult {
+        std::vector<Sample> samples;
+        std::unordered_map<std::string_view, SentenceCount> sentences; // Views into the input
+        bool timed = false;
+        bool dated = false;
+        int64_t baseNs = 0;  // Epoch time of chunk time 0, if dated
+        int64_t firstNs = 0; // Chunk time of the first and last timed sentences
+        int64_t lastNs = 0;
+        std::shared_ptr<const Utils::ReplayLog> recording; // Keeps the 'sentences' keys of a segment valid
+    };
+
+    // Per-task progress through a chunk
+    struct ChunkState {
+        ChunkResult result;
+        Core::CompactNavData partial; // Its timestamp is the one of the last update
+        Core::NavFieldMask updated = 0;
+        bool pending = false;         // 'partial' changed since the last sample
+        int64_t timeNs = -1;          // Chunk time of the current sentence
+        int64_t slot = -1;            // Interval of the pending sample
+    };
+
+    ChunkResult processChunk(const Chunk& chunk) const;
+    // 'recordedNs': receive time of a recorded sentence, -1 to take it from the sentence
+    void processSentence(std::string_view sentence, int64_t recordedNs, ChunkState& state) const;
+    static void flushSample(ChunkState& state);
+
+    // Chunks chained into one time line: an input when merging, every input when concatenating
+    struct Stream {
+        std::vector<const Chunk*> chunks;
+        std::optional<int64_t> startNs; // Probed epoch time, when merging
+        size_t submitted = 0;
+        std::deque<std::future<ChunkResult>> inFlight;
+
+        ChunkResult current;
+        size_t sample = 0;          // Next sample of 'current'
+        int64_t baseNs = 0;         // Output time of chunk time 0 in 'current'
+        bool dated = false;
+        int64_t untimedNs = 0;      // Output time of samples before the first timed sentence
+        Core::CompactNavData start; // State at the start of 'current'
+        Core::CompactNavData state;
+        int64_t endNs = -1;         // Output time of the last timed sentence
+        bool endDated = false;
+    };
+
+    std::vector<std::string> listInputs() const;
+    void planInput(const std::string& path);
+    void submitChunks(Stream& stream, size_t ahead);
+    bool loadChunk(Stream& stream, size_t ahead); // False at the end of the stream
+    void countSentences(const ChunkResult& result);
+    static int64_t headTime(const Stream& stream);
+    void mergeSample(Stream& stream);
+    void holdRow(int64_t timeNs, const Core::CompactNavData& state, bool dated);
+    void writeRow();
+
+    Core::ThreadPool& _pool;
+    Options _options;
+    int64_t _intervalNs;
+
+    std::deque<Utils::MappedFile> _files; // Text logs, mapped for the whole run
+    std::vector<Chunk> _chunks;
+    size_t _maxInFlight = 1;
+
+    // Merge state, on the calling thread
+    Core::CompactNavData _state; // Fused over every stream
+    bool _hasRow = false;
+    int64_t _rowNs = 0;  // Last row, held until the next one falls in another interval
+    Core::CompactNavData _row;
+    bool _rowDated = false;
+    std::map<std::string, SentenceCount> _sentences;
+    Summary _summary;
+
+    std::ofstream _csv;
+    std::ofstream _gpx;
+    std::string _line; // Formatting buffers, reused
+    std::string _point;
+};
+
+} // namespace App
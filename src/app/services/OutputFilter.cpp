@@ -0,0 +1,174 @@
+#include "OutputFilter.hpp"
+#include "core/AisTargetStore.hpp"
+#include "core/VesselStateStore.hpp"
+#include "parsers/NmeaFields.hpp"
+#include <cmath>
+#include <limits>
+
+namespace App {
+
+namespace {
+
+// Address field of "$GPRMC,..." / "!AIVDM,...": "GPRMC"
+std::string_view addressOf(std::string_view sentence) {
+    if (sentence.empty()) return {};
+    sentence.remove_prefix(1);
+    size_t end = sentence.find_first_of(",*");
+    return end == std::string_view::npos ? sentence : sentence.substr(0, end);
+}
+
+// Equirectangular approximation, fine at AIS ranges
+double distanceNm(double lat1, double lon1, double lat2, double lon2) {
+    constexpr double DegToRad = 3.14159265358979323846 / 180.0;
+    double dLon = std::remainder(lon2 - lon1, 360.0);
+    double x = dLon * std::cos((lat1 + lat2) * 0.5 * DegToRad);
+    double y = lat2 - lat1;
+    return std::sqrt(x * x + y * y) * 60.0; // 1 minute of arc = 1 NM
+}
+
+} // namespace
+
+OutputFilter::Pattern OutputFilter::Pattern::parse(std::string_view text) {
+    Pattern pattern;
+    if (text == "*" || text.empty()) return pattern;
+    if (text.front() == '*') {
+        pattern.formatter = text.substr(1);
+    } else if (text.back() == '*') {
+        pattern.talker = text.substr(0, text.size() - 1);
+    } else if (text.size() == 5) {
+        pattern.talker = text.substr(0, 2);
+        pattern.formatter = text.substr(2);
+    } else {
+        pattern.formatter = text; // Proprietary or unusual address: whole match
+    }
+    return pattern;
+}
+
+bool OutputFilter::Pattern::matches(std::string_view address) const {
+    if (!talker.empty() && address.substr(0, talker.size()) != talker) return false;
+    if (formatter.empty()) return true;
+    if (talker.empty() && address.size() != 5) return address == formatter;
+    return address.size() >= formatter.size() && address.substr(address.size() - formatter.size()) == formatter;
+}
+
+std::shared_ptr<OutputFilter> OutputFilter::compile(const DataOutputConfig& config) {
+    if (config.allowSentences.empty() && config.denySentences.empty() &&
+        config.rateLimits.empty() && config.aisRangeNm <= 0.0) {
+        return nullptr;
+    }
+
+    auto filter = std::make_shared<OutputFilter>();
+    for (const auto& text : config.allowSentences) filter->_allow.push_back(Pattern::parse(text));
+    for (const auto& text : config.denySentences) filter->_deny.push_back(Pattern::parse(text));
+    for (const auto& limit : config.rateLimits) {
+        if (limit.intervalMs <= 0) continue;
+        auto rate = std::make_unique<RateLimit>();
+        rate->pattern = Pattern::parse(limit.sentence);
+        rate->intervalNs = static_cast<int64_t>(limit.intervalMs) * 1000000;
+        rate->lastNs = std::numeric_limits<int64_t>::min() / 2;
+        filter->_rateLimits.push_back(std::move(rate));
+    }
+    filter->_aisRangeNm = config.aisRangeNm;
+    return filter;
+}
+
+bool OutputFilter::accept(std::string_view sentence, Core::SourceHandle source, const Parsers::AisMessage* ais) {
+    std::string_view address = addressOf(sentence);
+
+    for (const auto& pattern : _deny) {
+        if (pattern.matches(address)) return false;
+    }
+    if (!_allow.empty()) {
+        bool allowed = false;
+        for (const auto& pattern : _allow) {
+            if (pattern.matches(address)) {
+                allowed = true;
+                break;
+            }
+        }
+        if (!allowed) return false;
+    }
+
+    if (_aisRangeNm > 0.0 && !sentence.empty() && sentence[0] == '!' && !acceptAis(sentence, source, ais)) {
+        return false;
+    }
+
+    // Last, so that only sentences actually sent consume the interval
+    if (!_rateLimits.empty()) {
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        // Every matching limit must let it through before any interval is consumed
+        for (const auto& rate : _rateLimits) {
+            if (!rate->pattern.matches(address)) continue;
+            if (now - rate->lastNs.load(std::memory_order_relaxed) < rate->intervalNs) return false;
+        }
+
+        for (size_t i = 0; i < _rateLimits.size(); ++i) {
+            RateLimit& rate = *_rateLimits[i];
+            if (!rate.pattern.matches(address)) continue;
+            int64_t last = rate.lastNs.load(std::memory_order_relaxed);
+            // Concurrent sources: a single one wins the interval
+            if (now - last < rate.intervalNs || !rate.lastNs.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+                // Give back the intervals taken so far: 'now - interval' lets through
+                // exactly what the previous value did from now on
+                for (size_t j = 0; j < i; ++j) {
+                    RateLimit& taken = *_rateLimits[j];
+                    if (!taken.pattern.matches(address)) continue;
+                    int64_t expected = now;
+                    taken.lastNs.compare_exchange_strong(expected, now - taken.intervalNs, std::memory_order_relaxed);
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool OutputFilter::acceptAis(std::string_view sentence, Core::SourceHandle source, const Parsers::AisMessage* ais) {
+    // Without our own position there is nothing to measure from
+    Core::CompactNavData own = Core::VesselStateStore::instance().snapshot();
+    if (!own.has(Core::NavField::Position)) return true;
+
+    // !AIVDM,count,number,sequence,channel,payload,fill*hh
+    Parsers::NmeaFields fields;
+    fields.tokenize(sentence.substr(1, sentence.find('*') - 1));
+    int fragmentCount = 1;
+    int fragmentNumber = 1;
+    int sequenceId = -1;
+    Parsers::toInt(fields[1], fragmentCount);
+    Parsers::toInt(fields[2], fragmentNumber);
+    if (!Parsers::toInt(fields[3], sequenceId) || sequenceId < 0 ||
+        sequenceId >= static_cast<int>(Parsers::AisDecoder::MaxSequenceIds)) {
+        sequenceId = -1;
+    }
+
+    // Same multipart message: same source, sequence ID and channel
+    const uint64_t key = sequenceId < 0 ? 0 :
+        (static_cast<uint64_t>(source) * Parsers::AisDecoder::MaxSequenceIds + static_cast<uint64_t>(sequenceId)) *
+        Parsers::AisDecoder::ChannelCount + Parsers::AisDecoder::channelIndex(fields[4]);
+    std::atomic<uint64_t>& slot = _aisSequences[key % AisSequenceSlots];
+
+    if (fragmentCount > 1 && fragmentNumber > 1) {
+        if (sequenceId < 0) return false;
+        uint64_t entry = slot.load(std::memory_order_relaxed);
+        return (entry >> 1) == key + 1 && (entry & 1) != 0;
+    }
+
+    bool inRange = false;
+    if (ais && ais->hasPosition) {
+        inRange = distanceNm(own.latitude, own.longitude, ais->latitude, ais->longitude) <= _aisRangeNm;
+    } else {
+        // Static or first fragment: last known position of the target
+        uint32_t mmsi = ais ? ais->mmsi : Parsers::AisDecoder::peekMmsi(fields[5]);
+        auto target = mmsi ? Core::AisTargetStore::instance().get(mmsi) : std::nullopt;
+        inRange = target && target->hasPosition &&
+                  distanceNm(own.latitude, own.longitude, target->latitude, target->longitude) <= _aisRangeNm;
+    }
+
+    if (fragmentCount > 1 && sequenceId >= 0) {
+        slot.store(((key + 1) << 1) | (inRange ? 1 : 0), std::memory_order_relaxed);
+    }
+    return inRange;
+}
+
+} // namespace App
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "app/DataSourceConfig.hpp"
+#include "core/SourceRegistry.hpp"
+#include "parsers/AisDecoder.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace App {
+
+// Compiled filter rules of one output (DataOutputConfig), evaluated by the routing stage
+// before a sentence is queued. Thread-safe: sources call accept() concurrently.
+class OutputFilter {
+public:
+    // Null if the output has no filter rule
+    static std::shared_ptr<OutputFilter> compile(const DataOutputConfig& config);
+
+    // 'sentence' without CR/LF, received from 'source'. 'ais' is the decoded message the
+    // sentence completed, if any.
+    bool accept(std::string_view sentence, Core::SourceHandle source, const Parsers::AisMessage* ais);
+
+private:
+    struct Pattern {
+        std::string talker;    // Empty: any
+        std::string formatter; // Empty: any
+
+        static Pattern parse(std::string_view text);
+        bool matches(std::string_view address) const;
+    };
+
+    struct RateLimit {
+        Pattern pattern;
+        int64_t intervalNs = 0;
+        std::atomic<int64_t> lastNs{0}; // Steady clock time of the last sentence let through
+    };
+
+    bool acceptAis(std::string_view sentence, Core::SourceHandle source, const Parsers::AisMessage* ais);
+
+    std::vector<Pattern> _allow;
+    std::vector<Pattern> _deny;
+    std::vector<std::unique_ptr<RateLimit>> _rateLimits;
+    double _aisRangeNm = 0.0;
+
+    // Multipart AIS: decided on the first fragment, followed by the next ones of the same
+    // (source, sequence ID, channel). Direct-mapped: ((key + 1) << 1) | accepted, 0 if free.
+    // A fragment whose slot was taken over since its first one is dropped.
+    static constexpr size_t AisSequenceSlots = 256;
+    std::array<std::atomic<uint64_t>, AisSequenceSlots> _aisSequences{};
+};
+
+} // namespace App
@@ -0,0 +1,279 @@
+#include "Recorder.hpp"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace App {
+
+namespace Recording = Core::Recording;
+
+namespace {
+
+int64_t toNs(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// 'dest' has room for the header and the payload
+void writeRecord(char* dest, int64_t timestampNs, Core::SourceHandle source,
+                 Recording::RecordType type, std::string_view payload) {
+    Recording::RecordHeader header{};
+    header.timestampNs = timestampNs;
+    header.length = static_cast<uint32_t>(payload.size());
+    header.source = static_cast<uint16_t>(source);
+    header.type = static_cast<uint8_t>(type);
+
+    std::memcpy(dest, &header, sizeof(header));
+    std::memcpy(dest + sizeof(header), payload.data(), payload.size());
+}
+
+} // namespace
+
+Recorder::Recorder(const RecordingConfig& config) : _config(config) {}
+
+Recorder::~Recorder() {
+    stop();
+}
+
+bool Recorder::start() {
+    if (_running) return true;
+
+    try {
+        std::filesystem::create_directories(_config.directory);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create recording directory " << _config.directory << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    _free.clear();
+    _full.clear();
+    _free.reserve(BufferCount);
+    _full.reserve(BufferCount);
+    _writing.reserve(BufferCount);
+    for (size_t i = 0; i < BufferCount; ++i) {
+        auto buffer = std::make_unique<Buffer>();
+        buffer->data = std::make_unique<char[]>(BufferBytes);
+        _free.push_back(std::move(buffer));
+    }
+    _current = std::move(_free.back());
+    _free.pop_back();
+    _stop = false;
+    _flushDue = false;
+    _running = true;
+    _thread = std::thread([this] { run(); });
+    _flushTimer = Core::TimerScheduler::instance().schedulePeriodic(FlushInterval, [this] {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _flushDue = true;
+        }
+        _flushNeeded.notify_one();
+    }, FlushInterval / 4);
+    return true;
+}
+
+void Recorder::stop() {
+    if (!_running) return;
+    Core::TimerScheduler::instance().cancel(_flushTimer);
+    _flushTimer = Core::TimerScheduler::InvalidTimer;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _running = false;
+    }
+    _flushNeeded.notify_one();
+    if (_thread.joinable()) _thread.join();
+}
+
+void Recorder::record(std::string_view sentence, Core::SourceHandle source, std::chrono::steady_clock::time_point received) {
+    const size_t recordSize = sizeof(Recording::RecordHeader) + sentence.size();
+    if (recordSize > BufferBytes) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    bool flush = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stop) return;
+
+        // Full: hand it to the writer and continue in a free buffer
+        if (_current && _current->size + recordSize > BufferBytes) {
+            _full.push_back(std::move(_current));
+            flush = true;
+        }
+        if (!_current) {
+            if (_free.empty()) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            _current = std::move(_free.back());
+            _free.pop_back();
+        }
+
+        writeRecord(_current->data.get() + _current->size, toNs(received), source,
+                    Recording::RecordType::Sentence, sentence);
+        _current->size += recordSize;
+    }
+    if (flush) _flushNeeded.notify_one();
+}
+
+Recorder::Stats Recorder::getStats() const {
+    Stats stats;
+    stats.records = _records.load(std::memory_order_relaxed);
+    stats.bytes = _bytes.load(std::memory_order_relaxed);
+    stats.writes = _writes.load(std::memory_order_relaxed);
+    stats.dropped = _dropped.load(std::memory_order_relaxed);
+    stats.segments = _segments.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Recorder::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _flushNeeded.wait(lock, [this] { return _stop || _flushDue || !_full.empty(); });
+        bool stopping = _stop;
+        bool takePartial = stopping || _flushDue;
+        _flushDue = false;
+
+        _writing.swap(_full);
+        if (takePartial && _current && _current->size > 0) _writing.push_back(std::move(_current));
+        lock.unlock();
+
+        try {
+            for (const auto& buffer : _writing) writeBatch(buffer->data.get(), buffer->size);
+        } catch (const std::exception& e) {
+            std::cerr << "Recording failed: " << e.what() << std::endl;
+            closeSegment(); // The next batch starts a new segment
+        }
+
+        lock.lock();
+        for (auto& buffer : _writing) {
+            buffer->size = 0;
+            _free.push_back(std::move(buffer));
+        }
+        _writing.clear();
+
+        if (stopping) break;
+    }
+    lock.unlock();
+    closeSegment();
+}
+
+void Recorder::writeBatch(const char* batch, size_t size) {
+    const int64_t segmentDurationNs = static_cast<int64_t>(std::max(_config.segmentMinutes, 1)) * 60 * 1000000000LL;
+    const uint64_t segmentBytes = static_cast<uint64_t>(std::max(_config.segmentSizeMB, 1)) * 1024 * 1024;
+    const int64_t indexIntervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(IndexInterval).count();
+
+    // Written in as few calls as possible: only a new segment or a source first seen in the
+    // segment (its SourceName record goes first) cut the batch
+    size_t sliceStart = 0;
+    size_t pos = 0;
+    while (pos + sizeof(Recording::RecordHeader) <= size) {
+        Recording::RecordHeader header;
+        std::memcpy(&header, batch + pos, sizeof(header));
+        size_t recordSize = sizeof(header) + header.length;
+
+        uint64_t recordOffset = _offset + (pos - sliceStart);
+        bool rotate = _file.is_open() &&
+                      (recordOffset >= segmentBytes || header.timestampNs - _segmentStartNs >= segmentDurationNs);
+        if (rotate || !_file.is_open() || !_namedSources[header.source]) {
+            writeOut(batch + sliceStart, pos - sliceStart);
+            sliceStart = pos;
+
+            if (rotate) closeSegment();
+            if (!_file.is_open() && !openSegment(header.timestampNs)) return; // Logged, batch lost
+
+            if (!_namedSources[header.source]) {
+                const std::string& name = Core::SourceRegistry::instance().name(header.source);
+                std::vector<char> nameRecord(sizeof(Recording::RecordHeader) + name.size());
+                writeRecord(nameRecord.data(), header.timestampNs, header.source, Recording::RecordType::SourceName, name);
+                writeOut(nameRecord.data(), nameRecord.size());
+                _namedSources[header.source] = true;
+            }
+            recordOffset = _offset;
+        }
+
+        if (header.timestampNs >= _nextIndexNs) {
+            _index.push_back(Recording::IndexEntry{header.timestampNs, recordOffset});
+            _nextIndexNs = header.timestampNs + indexIntervalNs;
+        }
+        if (_trailer.recordCount == 0) _trailer.firstTimestampNs = header.timestampNs;
+        _trailer.lastTimestampNs = header.timestampNs;
+        _trailer.recordCount++;
+        _records.fetch_add(1, std::memory_order_relaxed);
+
+        pos += recordSize;
+    }
+
+    writeOut(batch + sliceStart, pos - sliceStart);
+    _file.flush();
+}
+
+void Recorder::writeOut(const char* data, size_t size) {
+    if (size == 0 || !_file.is_open()) return;
+    _file.write(data, static_cast<std::streamsize>(size));
+    if (!_file) throw std::runtime_error("write error on " + _segmentPath);
+    _offset += size;
+    _bytes.fetch_add(size, std::memory_order_relaxed);
+    _writes.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Recorder::openSegment(int64_t timestampNs) {
+    auto wallClock = std::chrono::system_clock::now();
+    auto monotonic = std::chrono::steady_clock::now();
+
+    std::time_t now = std::chrono::system_clock::to_time_t(wallClock);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    std::ostringstream name;
+    name << "navone-" << std::put_time(&utc, "%Y%m%d-%H%M%S") << "-" << _segmentNumber++ << Recording::Extension;
+    _segmentPath = (std::filesystem::path(_config.directory) / name.str()).string();
+
+    _file.open(_segmentPath, std::ios::binary | std::ios::trunc);
+    if (!_file) {
+        std::cerr << "Failed to open recording segment " << _segmentPath << std::endl;
+        _file.close();
+        return false;
+    }
+
+    Recording::SegmentHeader header{};
+    std::memcpy(header.magic, Recording::SegmentMagic, sizeof(header.magic));
+    header.version = Recording::Version;
+    header.headerSize = sizeof(header);
+    header.wallClockNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wallClock.time_since_epoch()).count();
+    header.monotonicNs = toNs(monotonic);
+
+    _offset = 0;
+    _segmentStartNs = timestampNs;
+    _nextIndexNs = timestampNs;
+    _index.clear();
+    _namedSources.assign(Core::SourceRegistry::MaxSources, false);
+    _trailer = Recording::SegmentTrailer{};
+    writeOut(reinterpret_cast<const char*>(&header), sizeof(header));
+    _segments.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void Recorder::closeSegment() {
+    if (!_file.is_open()) return;
+
+    try {
+        _trailer.indexOffset = _offset;
+        _trailer.indexCount = _index.size();
+        std::memcpy(_trailer.magic, Recording::TrailerMagic, sizeof(_trailer.magic));
+        writeOut(reinterpret_cast<const char*>(_index.data()), _index.size() * sizeof(Recording::IndexEntry));
+        writeOut(reinterpret_cast<const char*>(&_trailer), sizeof(_trailer));
+    } catch (const std::exception& e) {
+        std::cerr << "Recording failed: " << e.what() << std::endl;
+    }
+    _file.close();
+}
+
+} // namespace App
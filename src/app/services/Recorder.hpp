@@ -0,0 +1,105 @@
+#pragma once
+
+#include "app/DataSourceConfig.hpp"
+#include "core/RecordingFormat.hpp"
+#include "core/SourceRegistry.hpp"
+#include "core/TimerScheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace App {
+
+// Records every raw sentence, with its receive time and source, into segment files
+// (Core::Recording format).
+//
+// record() only copies the record into a memory buffer under a short lock: it never waits
+// for the disk and never allocates. Buffers have a fixed size and are all allocated by
+// start(). A full buffer goes to the writer thread, which also takes the partial one every
+// FlushInterval (a TimerScheduler task wakes it), writes them and hands them back.
+// If the disk can't keep up and no buffer is free, new sentences are dropped (and counted).
+class Recorder {
+public:
+    static constexpr std::chrono::milliseconds FlushInterval{200};
+    static constexpr size_t BufferBytes = 256 * 1024;
+    static constexpr size_t BufferCount = 16;
+    static constexpr size_t MaxPendingBytes = BufferBytes * BufferCount;
+    static constexpr std::chrono::seconds IndexInterval{1};
+
+    struct Stats {
+        uint64_t records = 0;
+        uint64_t bytes = 0;    // Written to disk
+        uint64_t writes = 0;
+        uint64_t dropped = 0;
+        uint64_t segments = 0;
+    };
+
+    explicit Recorder(const RecordingConfig& config);
+    ~Recorder();
+
+    // Creates the directory and starts the writer thread
+    bool start();
+    // Writes what is pending and closes the segment
+    void stop();
+    bool isRunning() const { return _running; }
+
+    // Any thread. 'sentence' without CR/LF.
+    void record(std::string_view sentence, Core::SourceHandle source, std::chrono::steady_clock::time_point received);
+
+    Stats getStats() const;
+
+private:
+    struct Buffer {
+        std::unique_ptr<char[]> data; // BufferBytes
+        size_t size = 0;
+    };
+
+    void run();
+    void writeBatch(const char* batch, size_t size);
+    void writeOut(const char* data, size_t size);
+    bool openSegment(int64_t timestampNs);
+    void closeSegment();
+
+    RecordingConfig _config;
+
+    // Filled by record(), taken by the writer. The vectors are reserved for every buffer.
+    std::mutex _mutex;
+    std::condition_variable _flushNeeded;
+    std::vector<std::unique_ptr<Buffer>> _free;
+    std::vector<std::unique_ptr<Buffer>> _full; // In record order
+    std::unique_ptr<Buffer> _current;           // Being filled, null if none was free
+    bool _flushDue = false;
+    bool _stop = false;
+    std::thread _thread;
+    Core::TimerScheduler::TimerId _flushTimer = Core::TimerScheduler::InvalidTimer;
+
+    // Writer thread
+    std::vector<std::unique_ptr<Buffer>> _writing;
+    std::ofstream _file;
+    std::string _segmentPath;
+    uint64_t _segmentNumber = 0;
+    uint64_t _offset = 0;          // Bytes written to the current segment
+    int64_t _segmentStartNs = 0;
+    int64_t _nextIndexNs = 0;
+    std::vector<Core::Recording::IndexEntry> _index;
+    std::vector<bool> _namedSources; // Sources with a SourceName record in this segment
+    Core::Recording::SegmentTrailer _trailer{};
+
+    std::atomic<uint64_t> _records{0};
+    std::atomic<uint64_t> _bytes{0};
+    std::atomic<uint64_t> _writes{0};
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _segments{0};
+
+    std::atomic<bool> _running{false};
+};
+
+} // namespace App
@@ -3,9 +3,16 @@
 #include "network/SerialService.hpp"
 #include "network/UdpService.hpp"
 #include "network/UdpSender.hpp"
+#include "network/TcpServer.hpp"
+#include "network/TcpClient.hpp"
+#include "network/ReplayService.hpp"
 #include "network/SimulatorService.hpp"
 #include "parsers/NmeaParser.hpp"
+#include "parsers/NmeaChecksum.hpp"
+#include "parsers/NmeaFramer.hpp"
+#include "parsers/AisDecoder.hpp"
 #include "core/MessageBus.hpp"
+#include "core/CompactNavData.hpp"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -24,6 +31,7 @@ void ServiceManager::loadConfig() {
     Utils::ConfigManager::instance().load();
     _sources = Utils::ConfigManager::instance().getSources();
     _outputs = Utils::ConfigManager::instance().getOutputs();
+    _recordingConfig = Utils::ConfigManager::instance().getRecordingConfig();
 
     if (_sources.empty()) {
         DataSourceConfig udpSource;
@@ -63,12 +71,15 @@ void ServiceManager::loadConfig() {
             updateOutputState(output);
         }
     }
+    updateRecordingState();
+    rebuildRoutes();
 }
 
 void ServiceManager::saveConfig() {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
     Utils::ConfigManager::instance().setSources(_sources);
     Utils::ConfigManager::instance().setOutputs(_outputs);
+    Utils::ConfigManager::instance().setRecordingConfig(_recordingConfig);
     Utils::ConfigManager::instance().save();
 }
 
@@ -78,11 +89,38 @@ void ServiceManager::stopAll() {
         if (pair.second) pair.second->stop();
     }
     _activeServices.clear();
+    _contexts.clear();
 
-    for (auto& pair : _activeOutputs) {
+    // Unpublish the outputs first: broadcasts in flight may still use the previous table
+    auto outputs = std::move(_activeOutputs);
+    _activeOutputs.clear();
+    auto recorder = std::move(_recorder);
+    _recorder.reset();
+    rebuildRoutes();
+    for (auto& pair : outputs) {
         if (pair.second) pair.second->stop();
     }
-    _activeOutputs.clear();
+    if (recorder) recorder->stop();
+}
+
+void ServiceManager::updateRecordingState() {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    // Restarted on any change: the new settings apply from a new segment
+    auto previous = std::move(_recorder);
+    _recorder.reset();
+    if (_recordingConfig.enabled) {
+        auto recorder = std::make_shared<Recorder>(_recordingConfig);
+        if (recorder->start()) _recorder = std::move(recorder);
+    }
+    rebuildRoutes();
+    if (previous) previous->stop();
+}
+
+std::optional<Recorder::Stats> ServiceManager::getRecorderStats() const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (!_recorder) return std::nullopt;
+    return _recorder->getStats();
 }
 
 void ServiceManager::stopService(const std::string& id) {
@@ -94,42 +132,80 @@ void ServiceManager::stopService(const std::string& id) {
         }
         _activeServices.erase(it);
     }
+    _contexts.erase(id);
 }
 
 void ServiceManager::stopOutput(const std::string& id) {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
     auto it = _activeOutputs.find(id);
     if (it != _activeOutputs.end()) {
-        if (it->second) {
-            it->second->stop();
-        }
+        std::shared_ptr<Network::IService> service = std::move(it->second);
         _activeOutputs.erase(it);
+        rebuildRoutes();
+        if (service) {
+            service->stop();
+        }
     }
 }
 
-void ServiceManager::broadcast(const std::string& data, const std::string& sourceId) {
+void ServiceManager::broadcast(const Core::SentenceRef& sentence, Core::SourceHandle source,
+                               const Parsers::AisMessage* ais) const {
+    std::shared_ptr<const RoutingTable> routes = _routes.load(std::memory_order_acquire);
+    if (routes->recorder) {
+        routes->recorder->record(sentence.sentence(), source, std::chrono::steady_clock::now());
+    }
+    for (const auto& route : routes->outputsOf(source)) {
+        if (route.filter && !route.filter->accept(sentence.sentence(), source, ais)) continue;
+        route.output->send(sentence);
+    }
+}
+
+void ServiceManager::rebuildRoutes() {
     std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto routes = std::make_shared<RoutingTable>();
+    routes->recorder = _recorder;
+
+    // One filter per output, shared by all its sources (rate limits are per output)
+    std::vector<std::pair<const DataOutputConfig*, Route>> active;
     for (const auto& outputConfig : _outputs) {
         if (!outputConfig.enabled) continue;
+        auto it = _activeOutputs.find(outputConfig.id);
+        if (it == _activeOutputs.end() || !it->second) continue;
+        Route route{it->second, OutputFilter::compile(outputConfig)};
+        active.emplace_back(&outputConfig, route);
+        if (outputConfig.multiplexAll) routes->toAll.push_back(route);
+    }
 
-        // Check multiplexing rules
-        bool shouldSend = outputConfig.multiplexAll;
-        if (!shouldSend) {
-            for (const auto& allowedId : outputConfig.sourceIds) {
-                if (allowedId == sourceId) {
-                    shouldSend = true;
-                    break;
-                }
-            }
-        }
+    for (const auto& sourceConfig : _sources) {
+        Core::SourceHandle handle = sourceHandle(sourceConfig);
+        if (handle == Core::SourceRegistry::NoSource) continue;
+        if (routes->bySource.size() <= handle) routes->bySource.resize(handle + 1, routes->toAll);
 
-        if (shouldSend) {
-            auto it = _activeOutputs.find(outputConfig.id);
-            if (it != _activeOutputs.end() && it->second && it->second->isRunning()) {
-                it->second->send(data);
-            }
+        auto& outputs = routes->bySource[handle];
+        outputs.clear();
+        for (const auto& [outputConfig, route] : active) {
+            bool selected = outputConfig->multiplexAll ||
+                std::find(outputConfig->sourceIds.begin(), outputConfig->sourceIds.end(), sourceConfig.id) != outputConfig->sourceIds.end();
+            if (selected) outputs.push_back(route);
         }
     }
+
+    _routes.store(std::move(routes), std::memory_order_release);
+}
+
+std::string ServiceManager::logSourceName(const DataSourceConfig& config) {
+    switch (config.type) {
+        case SourceType::Serial: return "SERIAL:" + config.id;
+        case SourceType::Udp: return "UDP:" + config.id;
+        case SourceType::TcpClient: return "TCP:" + config.id;
+        case SourceType::Replay: return "REPLAY:" + config.id;
+        case SourceType::Simulator: return config.id;
+    }
+    return config.id;
+}
+
+Core::SourceHandle ServiceManager::sourceHandle(const DataSourceConfig& config) {
+    return Core::SourceRegistry::instance().intern(logSourceName(config));
 }
 
 void ServiceManager::updateOutputState(const DataOutputConfig& config) {
@@ -148,17 +224,24 @@ void ServiceManager::updateOutputState(const DataOutputConfig& config) {
             // But SerialService constructor requires a callback.
             // Let's pass an empty lambda.
             auto service = std::make_unique<Network::SerialService>(config.portName, config.baudRate, 
-                [](const std::vector<char>&, const std::string&) {});
+                [](std::string_view, const std::string&) {});
             service->start();
             _activeOutputs[config.id] = std::move(service);
         } else if (config.type == OutputType::Udp) {
-            auto service = std::make_unique<Network::UdpSender>(config.address, config.port);
+            size_t maxDatagram = config.coalesce ? static_cast<size_t>(std::max(config.maxDatagramSize, 64)) : 0;
+            auto service = std::make_unique<Network::UdpSender>(config.address, config.port, maxDatagram,
+                                                                std::chrono::milliseconds(std::max(config.flushDelayMs, 0)));
+            service->start();
+            _activeOutputs[config.id] = std::move(service);
+        } else if (config.type == OutputType::TcpServer) {
+            auto service = std::make_unique<Network::TcpServer>(config.port, static_cast<size_t>(std::max(config.maxClients, 1)));
             service->start();
             _activeOutputs[config.id] = std::move(service);
         }
     } catch (const std::exception& e) {
         std::cerr << "Failed to start output " << config.name << ": " << e.what() << std::endl;
     }
+    rebuildRoutes();
 }
 
 void ServiceManager::updateServiceState(const DataSourceConfig& config) {
@@ -175,64 +258,70 @@ void ServiceManager::updateServiceState(const DataSourceConfig& config) {
             auto service = std::make_unique<Network::SimulatorService>();
             service->start();
             _activeServices[config.id] = std::move(service);
-            return;
         } else if (config.type == SourceType::Serial) {
+            // Reads can end anywhere: a per-source framer rebuilds whole sentences
+            auto context = createContext(config);
+            context->framer.emplace();
+
             auto service = std::make_unique<Network::SerialService>(config.portName, config.baudRate, 
-                [this, id = config.id](const std::vector<char>& data, const std::string& source) {
-                    std::string sentence(data.begin(), data.end());
-                    sentence.erase(std::remove(sentence.begin(), sentence.end(), '\n'), sentence.end());
-                    sentence.erase(std::remove(sentence.begin(), sentence.end(), '\r'), sentence.end());
-
-                    std::stringstream ss(sentence);
-                    std::string segment;
-                    while(std::getline(ss, segment, '$')) {
-                        if (segment.empty()) continue;
-                        std::string fullSentence = "$" + segment;
-                        
-                        // Multiplexing: Broadcast raw sentence
-                        broadcast(fullSentence + "\r\n", id);
-
-                        {
-                            std::lock_guard<std::recursive_mutex> cbLock(_mutex);
-                            if (_logCallback) _logCallback("SERIAL:" + id, fullSentence);
-                        }
-
-                        Core::NavData navData;
-                        navData.timestamp = std::chrono::system_clock::now();
-                        navData.sourceId = "SERIAL:" + id;
-                        
-                        if (Parsers::NmeaParser::parse(fullSentence, navData)) {
-                            Core::MessageBus::instance().publish(navData);
-                        }
-                    }
+                [this, context](std::string_view data, const std::string& source) {
+                    context->framer->feed(data, [&](std::string_view sentence) {
+                        handleSentence(*context, sentence, Parsers::NmeaChecksum::verify(sentence));
+                    });
                 });
             service->start();
             _activeServices[config.id] = std::move(service);
         } else if (config.type == SourceType::Udp) {
+            Network::UdpListenOptions options;
+            options.multicastGroup = config.multicastGroup;
+            options.interfaceAddress = config.interfaceAddress;
+            options.sourceFilter = config.sourceFilter;
+            options.shared = config.sharedPort;
+            options.receivers = static_cast<size_t>(std::max(config.udpReceivers, 1));
+
+            // Receivers run concurrently: each has its own context (AIS multipart state).
+            // A peer always reaches the same receiver, so its fragments stay together.
+            std::vector<std::shared_ptr<SourceContext>> contexts;
+            for (size_t i = Network::UdpService::receiverCount(options); i > 0; --i) {
+                contexts.push_back(createContext(config));
+            }
+
             auto service = std::make_unique<Network::UdpService>(config.port, 
-                [this, id = config.id](const std::vector<char>& data, const std::string& source) {
-                    std::string sentence(data.begin(), data.end());
-                    sentence.erase(std::remove(sentence.begin(), sentence.end(), '\n'), sentence.end());
-                    sentence.erase(std::remove(sentence.begin(), sentence.end(), '\r'), sentence.end());
-
-                    // Multiplexing: Broadcast raw sentence
-                    // Note: UDP packets might contain multiple sentences or partials, but assuming line based for now or packet based.
-                    // If packet based, we might want to forward the whole packet.
-                    // But here we cleaned it up. Let's forward the cleaned sentence with CRLF.
-                    broadcast(sentence + "\r\n", id);
-
-                    {
-                        std::lock_guard<std::recursive_mutex> cbLock(_mutex);
-                        if (_logCallback) _logCallback("UDP:" + id, sentence);
-                    }
+                [this, contexts](std::string_view datagram, const std::string& source, size_t receiver) {
+                    SourceContext& context = *contexts[receiver];
+                    // A datagram may carry several CR/LF delimited sentences:
+                    // split and check them all in one vectorized pass.
+                    thread_local std::vector<Parsers::SentenceRecord> records;
+                    records.clear();
+                    Parsers::NmeaChecksum::validateBatch(datagram, records);
 
-                    Core::NavData navData;
-                    navData.timestamp = std::chrono::system_clock::now();
-                    navData.sourceId = "UDP:" + id;
-                    
-                    if (Parsers::NmeaParser::parse(sentence, navData)) {
-                        Core::MessageBus::instance().publish(navData);
+                    for (const auto& record : records) {
+                        handleSentence(context, datagram.substr(record.offset, record.length), record.valid);
                     }
+                }, options);
+            service->start();
+            _activeServices[config.id] = std::move(service);
+        } else if (config.type == SourceType::TcpClient) {
+            // A stream, like serial: framed, and restarted clean on each reconnection
+            auto context = createContext(config);
+            context->framer.emplace();
+
+            auto service = std::make_unique<Network::TcpClient>(config.address, config.port,
+                [this, context](std::string_view data, const std::string& source) {
+                    context->framer->feed(data, [&](std::string_view sentence) {
+                        handleSentence(*context, sentence, Parsers::NmeaChecksum::verify(sentence));
+                    });
+                },
+                [context]() { context->framer->reset(); });
+            service->start();
+            _activeServices[config.id] = std::move(service);
+        } else if (config.type == SourceType::Replay) {
+            // Whole sentences, as recorded: no framer
+            auto context = createContext(config);
+
+            auto service = std::make_unique<Network::ReplayService>(config.replayPath, config.replaySpeed, config.replayLoop,
+                [this, context](std::string_view sentence) {
+                    handleSentence(*context, sentence, Parsers::NmeaChecksum::verify(sentence));
                 });
             service->start();
             _activeServices[config.id] = std::move(service);
@@ -240,6 +329,86 @@ void ServiceManager::updateServiceState(const DataSourceConfig& config) {
     } catch (const std::exception& e) {
         std::cerr << "Failed to start service " << config.name << ": " << e.what() << std::endl;
     }
+    rebuildRoutes(); // The source may be new or have changed type (handle)
+}
+
+std::shared_ptr<ServiceManager::SourceContext> ServiceManager::createContext(const DataSourceConfig& config) {
+    auto context = std::make_shared<SourceContext>();
+    context->logSource = logSourceName(config);
+    context->source = Core::SourceRegistry::instance().intern(context->logSource);
+    _contexts[config.id].push_back(context);
+    return context;
+}
+
+void ServiceManager::handleSentence(SourceContext& context, std::string_view sentence, bool checksumValid) {
+    // AIS: decoded into Core::AisTargetStore before routing, for the range filters.
+    // Multipart state is per source.
+    bool isAis = checksumValid && sentence[0] == '!';
+    Parsers::AisMessage aisMessage;
+    bool aisDecoded = isAis && context.ais.decode(sentence, &aisMessage) == Parsers::AisDecoder::Status::Decoded;
+
+    // Single copy of the sentence, shared by every output
+    Core::SentenceRef ref = Core::SentenceRef::make(sentence);
+
+    // Multiplexing: Broadcast raw sentence
+    broadcast(ref, context.source, aisDecoded ? &aisMessage : nullptr);
+
+    if (auto log = _logCallback.load(std::memory_order_acquire)) {
+        (*log)(context.logSource, ref.sentence());
+    }
+
+    if (!checksumValid || isAis) return;
+
+    Core::NavData navData;
+    navData.timestamp = std::chrono::system_clock::now();
+
+    if (Parsers::NmeaParser::parse(sentence, navData)) {
+        Core::MessageBus::instance().publish(Core::CompactNavData::fromNavData(navData, context.source));
+    }
+}
+
+std::optional<Parsers::NmeaFramer::Stats> ServiceManager::getFramerStats(const std::string& id) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _contexts.find(id);
+    if (it == _contexts.end() || !it->second.front()->framer) return std::nullopt;
+    return it->second.front()->framer->getStats(); // Stream sources have a single context
+}
+
+std::optional<Parsers::AisDecoder::Stats> ServiceManager::getAisStats(const std::string& id) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _contexts.find(id);
+    if (it == _contexts.end()) return std::nullopt;
+
+    Parsers::AisDecoder::Stats total;
+    for (const auto& context : it->second) {
+        Parsers::AisDecoder::Stats stats = context->ais.getStats();
+        total.decoded += stats.decoded;
+        total.unsupported += stats.unsupported;
+        total.errors += stats.errors;
+        total.droppedFragments += stats.droppedFragments;
+    }
+    return total;
+}
+
+std::optional<Network::TrafficStats> ServiceManager::getOutputStats(const std::string& id) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _activeOutputs.find(id);
+    if (it == _activeOutputs.end() || !it->second) return std::nullopt;
+    return it->second->getTrafficStats();
+}
+
+std::vector<Network::PeerStats> ServiceManager::getOutputPeers(const std::string& id) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _activeOutputs.find(id);
+    if (it == _activeOutputs.end() || !it->second) return {};
+    return it->second->getPeerStats();
+}
+
+Network::ReplayService* ServiceManager::getReplay(const std::string& id) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _activeServices.find(id);
+    if (it == _activeServices.end()) return nullptr;
+    return dynamic_cast<Network::ReplayService*>(it->second.get());
 }
 
 bool ServiceManager::isSourceEnabled(const std::string& id) const {
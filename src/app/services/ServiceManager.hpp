@@ -1,25 +1,38 @@
 #pragma once
 
 #include "app/DataSourceConfig.hpp"
+#include "app/services/OutputFilter.hpp"
+#include "app/services/Recorder.hpp"
 #include "network/IService.hpp"
+#include "parsers/NmeaFramer.hpp"
+#include "parsers/AisDecoder.hpp"
+#include "core/SourceRegistry.hpp"
+#include "core/SentenceRef.hpp"
+#include <atomic>
 #include <vector>
 #include <map>
 #include <memory>
 #include <functional>
 #include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace Network { class ReplayService; }
 
 namespace App {
 
 class ServiceManager {
 public:
-    using LogCallback = std::function<void(const std::string& source, const std::string& frame)>;
+    // 'frame' is only valid during the call. Called concurrently from the I/O threads.
+    using LogCallback = std::function<void(const std::string& source, std::string_view frame)>;
 
     ServiceManager();
     ~ServiceManager();
 
-    void setLogCallback(LogCallback callback) { 
-        std::lock_guard<std::recursive_mutex> lock(_mutex);
-        _logCallback = callback; 
+    // Read lock-free by the I/O threads, like the routing table
+    void setLogCallback(LogCallback callback) {
+        _logCallback.store(callback ? std::make_shared<const LogCallback>(std::move(callback)) : nullptr,
+                           std::memory_order_release);
     }
 
     void loadConfig();
@@ -40,25 +53,87 @@ public:
     std::unique_lock<std::recursive_mutex> getLock() const { return std::unique_lock<std::recursive_mutex>(_mutex); }
 
     const std::map<std::string, std::unique_ptr<Network::IService>>& getActiveServices() const { return _activeServices; }
-    const std::map<std::string, std::unique_ptr<Network::IService>>& getActiveOutputs() const { return _activeOutputs; }
+    const std::map<std::string, std::shared_ptr<Network::IService>>& getActiveOutputs() const { return _activeOutputs; }
 
     void updateOutputState(const DataOutputConfig& config);
     void stopOutput(const std::string& id);
 
-    // Multiplexing
-    void broadcast(const std::string& data, const std::string& sourceId);
+    // Multiplexing: lock-free, through the routing table and the filters of each output.
+    // 'ais' is the message decoded from the sentence, if any (AIS range filters).
+    void broadcast(const Core::SentenceRef& sentence, Core::SourceHandle source,
+                   const Parsers::AisMessage* ais = nullptr) const;
+
+    // Recompiles the multiplexing and filter rules, after editing getOutputs() in place.
+    // Starting/stopping sources and outputs does it already.
+    void rebuildRoutes();
+
+    // Handle under which a source logs and publishes, e.g. "UDP:<id>"
+    static Core::SourceHandle sourceHandle(const DataSourceConfig& config);
 
     bool isSourceEnabled(const std::string& id) const;
 
+    // Framing counters of a stream source (serial), if it has a framer
+    std::optional<Parsers::NmeaFramer::Stats> getFramerStats(const std::string& id) const;
+
+    // AIS decoding counters of a source, if it is running (summed over its receivers)
+    std::optional<Parsers::AisDecoder::Stats> getAisStats(const std::string& id) const;
+
+    // Traffic counters of an output, if it is running
+    std::optional<Network::TrafficStats> getOutputStats(const std::string& id) const;
+
+    // Connected clients of a server output (empty for other outputs)
+    std::vector<Network::PeerStats> getOutputPeers(const std::string& id) const;
+
+    // Playback controls of a running replay source, null otherwise.
+    // Only valid while holding getLock(): the source may be stopped by another thread.
+    Network::ReplayService* getReplay(const std::string& id) const;
+
+    // Recording of every raw sentence received (Recorder)
+    RecordingConfig& getRecordingConfig() { return _recordingConfig; }
+    void updateRecordingState(); // Applies getRecordingConfig()
+    std::optional<Recorder::Stats> getRecorderStats() const;
+
 private:
+    // Per-source ingest state, only touched by the thread of that source's service
+    struct SourceContext {
+        std::string logSource;     // e.g. "SERIAL:<id>"
+        Core::SourceHandle source; // Interned logSource, tags published data
+        std::optional<Parsers::NmeaFramer> framer; // Stream sources only
+        Parsers::AisDecoder ais;
+    };
+
+    // Outputs of each source, immutable once published
+    struct Route {
+        std::shared_ptr<Network::IService> output;
+        std::shared_ptr<OutputFilter> filter; // Null: forward everything
+    };
+    struct RoutingTable {
+        using Outputs = std::vector<Route>;
+        std::vector<Outputs> bySource; // Indexed by SourceHandle
+        Outputs toAll;                 // Outputs multiplexing every source, for unlisted handles
+        std::shared_ptr<Recorder> recorder; // Gets every sentence, before the filters
+
+        const Outputs& outputsOf(Core::SourceHandle source) const {
+            return source < bySource.size() ? bySource[source] : toAll;
+        }
+    };
+
+    // Ingest path shared by all sources: forward, log, parse and publish one sentence
+    void handleSentence(SourceContext& context, std::string_view sentence, bool checksumValid);
+    std::shared_ptr<SourceContext> createContext(const DataSourceConfig& config);
+    static std::string logSourceName(const DataSourceConfig& config);
+
     mutable std::recursive_mutex _mutex;
     std::vector<DataSourceConfig> _sources;
     std::vector<DataOutputConfig> _outputs;
     
     std::map<std::string, std::unique_ptr<Network::IService>> _activeServices;
-    std::map<std::string, std::unique_ptr<Network::IService>> _activeOutputs;
-    
-    LogCallback _logCallback;
+    std::map<std::string, std::shared_ptr<Network::IService>> _activeOutputs; // Shared with the routing table
+    std::map<std::string, std::vector<std::shared_ptr<SourceContext>>> _contexts; // One per receiver, usually one
+    RecordingConfig _recordingConfig;
+    std::shared_ptr<Recorder> _recorder; // Shared with the routing table
+    std::atomic<std::shared_ptr<const RoutingTable>> _routes{std::make_shared<const RoutingTable>()};
+    std::atomic<std::shared_ptr<const LogCallback>> _logCallback;
 };
 
 } // namespace App
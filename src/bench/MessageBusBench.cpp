@@ -0,0 +1,161 @@
+// Publish latency of Core::MessageBus as subscribers and publishing threads scale up,
+// compared with the previous design (listener map called under a mutex).
+// A background thread keeps subscribing/unsubscribing to exercise snapshot swaps.
+// A second table shows the cost of topic-filtered subscribers for updates they don't match.
+//
+// Build with -DNAVONE_BUILD_BENCHMARKS=ON, run MessageBusBench [publishesPerThread]
+
+#include "core/MessageBus.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Previous MessageBus implementation, for reference
+class LockedBus {
+public:
+    size_t subscribe(Core::MessageBus::Callback callback) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t id = _nextId++;
+        _listeners[id] = callback;
+        return id;
+    }
+
+    void unsubscribe(size_t id) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _listeners.erase(id);
+    }
+
+    void publish(const Core::CompactNavData& data) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& [id, callback] : _listeners) {
+            callback(data);
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::map<size_t, Core::MessageBus::Callback> _listeners;
+    size_t _nextId = 0;
+};
+
+struct Result {
+    double meanNs = 0.0;
+    double p50Ns = 0.0;
+    double p99Ns = 0.0;
+};
+
+// Cheap listener: touches the data like a real consumer would, without shared writes
+thread_local uint64_t t_sink = 0;
+
+void consume(const Core::CompactNavData& data) {
+    if (data.has(Core::NavField::Depth)) t_sink += static_cast<uint64_t>(data.depth) + 1;
+}
+
+template<class Bus>
+Result run(Bus& bus, size_t subscribers, size_t publishers, size_t publishesPerThread) {
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < subscribers; ++i) ids.push_back(bus.subscribe(consume));
+
+    std::atomic<bool> churn{true};
+    std::thread churner([&] {
+        while (churn.load(std::memory_order_relaxed)) {
+            size_t id = bus.subscribe(consume);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            bus.unsubscribe(id);
+        }
+    });
+
+    std::vector<std::vector<uint32_t>> samples(publishers);
+    std::vector<std::thread> threads;
+    std::atomic<size_t> ready{0};
+    for (size_t t = 0; t < publishers; ++t) {
+        threads.emplace_back([&, t] {
+            Core::CompactNavData data;
+            data.fields = Core::NavField::Depth;
+            auto& out = samples[t];
+            out.reserve(publishesPerThread);
+            ready.fetch_add(1);
+            while (ready.load() < publishers) std::this_thread::yield();
+
+            for (size_t i = 0; i < publishesPerThread; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                bus.publish(data);
+                auto end = std::chrono::steady_clock::now();
+                out.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    churn = false;
+    churner.join();
+    for (size_t id : ids) bus.unsubscribe(id);
+
+    std::vector<uint32_t> all;
+    for (const auto& s : samples) all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end());
+
+    Result result;
+    double total = 0.0;
+    for (uint32_t v : all) total += v;
+    result.meanNs = total / all.size();
+    result.p50Ns = all[all.size() / 2];
+    result.p99Ns = all[all.size() * 99 / 100];
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t publishesPerThread = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    const size_t subscriberCounts[] = {1, 4, 16, 64};
+    const size_t publisherCounts[] = {1, 2, 4, 8};
+
+    std::printf("%-5s %-5s | %-28s | %-28s\n", "subs", "pubs", "MessageBus mean/p50/p99 (ns)", "locked map mean/p50/p99 (ns)");
+    for (size_t subscribers : subscriberCounts) {
+        for (size_t publishers : publisherCounts) {
+            Result snapshot = run(Core::MessageBus::instance(), subscribers, publishers, publishesPerThread);
+            LockedBus locked;
+            Result legacy = run(locked, subscribers, publishers, publishesPerThread);
+            std::printf("%-5zu %-5zu | %8.0f %8.0f %10.0f | %8.0f %8.0f %10.0f\n", subscribers, publishers,
+                        snapshot.meanNs, snapshot.p50Ns, snapshot.p99Ns, legacy.meanNs, legacy.p50Ns, legacy.p99Ns);
+        }
+    }
+
+    // Narrow consumers (e.g. depth alarms) don't cost anything to updates they don't want
+    std::printf("\n%-5s | %-28s | %-28s\n", "subs", "wind update, depth-only subs", "wind update, unfiltered subs");
+    for (size_t subscribers : subscriberCounts) {
+        auto& bus = Core::MessageBus::instance();
+        std::vector<Core::MessageBus::ListenerId> ids;
+        Core::CompactNavData wind;
+        wind.fields = Core::NavField::Wind;
+
+        auto measure = [&] {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < publishesPerThread; ++i) bus.publish(wind);
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / publishesPerThread;
+        };
+
+        for (size_t i = 0; i < subscribers; ++i) ids.push_back(bus.subscribe(consume, Core::NavField::Depth));
+        double filtered = measure();
+        for (auto id : ids) bus.unsubscribe(id);
+        ids.clear();
+
+        for (size_t i = 0; i < subscribers; ++i) ids.push_back(bus.subscribe(consume));
+        double unfiltered = measure();
+        for (auto id : ids) bus.unsubscribe(id);
+
+        std::printf("%-5zu | %24.0f ns | %24.0f ns\n", subscribers, filtered, unfiltered);
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Task throughput of Core::ThreadPool (work stealing) against the previous pool
+// (single mutex-protected queue, std::bind + packaged_task per task), for 1 to N workers.
+//
+// - external:  tasks submitted from the main thread
+// - fan-out:   each task submits children from inside the pool (recursive splitting)
+//
+// Build with -DNAVONE_BUILD_BENCHMARKS=ON, run ThreadPoolBench [tasks] [maxWorkers]
+
+#include "core/ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Previous Core::ThreadPool implementation, for reference
+class LegacyThreadPool {
+public:
+    explicit LegacyThreadPool(size_t numThreads) : _stop(false) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            _workers.emplace_back([this] {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(_queueMutex);
+                        _condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                        if (_stop && _tasks.empty()) return;
+                        task = std::move(_tasks.front());
+                        _tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~LegacyThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (auto& worker : _workers) worker.join();
+    }
+
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+        auto task = std::make_shared<std::packaged_task<return_type()>>(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        std::future<return_type> res = task->get_future();
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _tasks.emplace([task]() { (*task)(); });
+        }
+        _condition.notify_one();
+        return res;
+    }
+
+    // No fire-and-forget in the previous API
+    template<class F>
+    void post(F&& f) { enqueue(std::forward<F>(f)); }
+
+private:
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _queueMutex;
+    std::condition_variable _condition;
+    bool _stop;
+};
+
+struct Latch {
+    std::atomic<size_t> remaining;
+    std::mutex mutex;
+    std::condition_variable done;
+
+    explicit Latch(size_t count) : remaining(count) {}
+
+    void countDown() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return remaining.load() == 0; });
+    }
+};
+
+template<class Pool>
+double external(size_t workers, size_t tasks, bool useFutures) {
+    Pool pool(workers);
+    Latch latch(tasks);
+    auto start = std::chrono::steady_clock::now();
+    if (useFutures) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks);
+        for (size_t i = 0; i < tasks; ++i) futures.push_back(pool.enqueue([&latch] { latch.countDown(); }));
+        for (auto& future : futures) future.get();
+    } else {
+        for (size_t i = 0; i < tasks; ++i) pool.post([&latch] { latch.countDown(); });
+        latch.wait();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return tasks / std::chrono::duration<double>(end - start).count();
+}
+
+template<class Pool>
+void split(Pool& pool, Latch& latch, size_t count) {
+    if (count == 1) {
+        latch.countDown();
+        return;
+    }
+    size_t half = count / 2;
+    pool.post([&pool, &latch, half] { split(pool, latch, half); });
+    pool.post([&pool, &latch, count, half] { split(pool, latch, count - half); });
+}
+
+template<class Pool>
+double fanOut(size_t workers, size_t tasks) {
+    Pool pool(workers);
+    Latch latch(tasks);
+    auto start = std::chrono::steady_clock::now();
+    split(pool, latch, tasks);
+    latch.wait();
+    auto end = std::chrono::steady_clock::now();
+    return tasks / std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t tasks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    size_t maxWorkers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    if (maxWorkers == 0) maxWorkers = 4;
+
+    std::printf("Mtasks/s (%zu tasks)\n", tasks);
+    std::printf("%-8s | %-21s | %-21s | %-21s\n", "workers", "external post", "external enqueue", "fan-out post");
+    std::printf("%-8s | %10s %10s | %10s %10s | %10s %10s\n", "", "stealing", "legacy", "stealing", "legacy", "stealing", "legacy");
+    for (size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        std::printf("%-8zu | %10.2f %10.2f | %10.2f %10.2f | %10.2f %10.2f\n", workers,
+                    external<Core::ThreadPool>(workers, tasks, false) / 1e6,
+                    external<LegacyThreadPool>(workers, tasks, false) / 1e6,
+                    external<Core::ThreadPool>(workers, tasks, true) / 1e6,
+                    external<LegacyThreadPool>(workers, tasks, true) / 1e6,
+                    fanOut<Core::ThreadPool>(workers, tasks) / 1e6,
+                    fanOut<LegacyThreadPool>(workers, tasks) / 1e6);
+    }
+    return 0;
+}
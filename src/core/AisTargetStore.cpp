@@ -0,0 +1,66 @@
+#include "AisTargetStore.hpp"
+
+namespace Core {
+
+static_assert(AisTargetStore::ShardCount == 64, "shardFor() keeps the top 6 bits of the hash");
+
+AisTargetStore::AisTargetStore() : _shards(new Shard[ShardCount]) {
+    for (size_t i = 0; i < ShardCount; ++i) {
+        _shards[i].targets.reserve(ExpectedTargets / ShardCount);
+    }
+}
+
+std::optional<AisTarget> AisTargetStore::get(uint32_t mmsi) const {
+    const Shard& shard = shardFor(mmsi);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.targets.find(mmsi);
+    if (it == shard.targets.end()) return std::nullopt;
+    return it->second;
+}
+
+std::vector<AisTarget> AisTargetStore::snapshot() const {
+    std::vector<AisTarget> result;
+    result.reserve(size());
+    for (size_t i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(_shards[i].mutex);
+        for (const auto& [mmsi, target] : _shards[i].targets) {
+            result.push_back(target);
+        }
+    }
+    return result;
+}
+
+size_t AisTargetStore::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(_shards[i].mutex);
+        total += _shards[i].targets.size();
+    }
+    return total;
+}
+
+size_t AisTargetStore::expire(std::chrono::system_clock::time_point olderThan) {
+    size_t removed = 0;
+    for (size_t i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(_shards[i].mutex);
+        auto& targets = _shards[i].targets;
+        for (auto it = targets.begin(); it != targets.end();) {
+            if (it->second.lastUpdate < olderThan) {
+                it = targets.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return removed;
+}
+
+void AisTargetStore::clear() {
+    for (size_t i = 0; i < ShardCount; ++i) {
+        std::lock_guard<std::mutex> lock(_shards[i].mutex);
+        _shards[i].targets.clear();
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Core {
+
+// Latest known state of one AIS station, merged from all its messages.
+// Fixed-size text fields keep it trivially copyable (cheap snapshots).
+struct AisTarget {
+    uint32_t mmsi = 0;
+    uint8_t lastMessageType = 0;
+    bool isClassB = false;
+    bool isAidToNavigation = false;
+
+    // Dynamic data (messages 1/2/3/18/19/27)
+    bool hasPosition = false;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double speedOverGround = 0.0;  // Knots, negative if not available
+    double courseOverGround = 0.0; // Degrees, negative if not available
+    int heading = -1;              // Degrees, -1 if not available
+    int navigationStatus = 15;     // 15 = not defined
+
+    // Static data (messages 5/19/24/21)
+    bool hasStatic = false;
+    uint32_t imo = 0;
+    uint8_t shipType = 0;
+    uint8_t aidType = 0; // Message 21 only
+    uint16_t toBow = 0;
+    uint16_t toStern = 0;
+    uint8_t toPort = 0;
+    uint8_t toStarboard = 0;
+    double draught = 0.0; // Meters
+    std::array<char, 35> name{};       // 20 chars, 34 with the message 21 extension
+    std::array<char, 8> callsign{};
+    std::array<char, 21> destination{};
+
+    std::chrono::system_clock::time_point lastUpdate;
+
+    std::string_view getName() const { return name.data(); }
+    std::string_view getCallsign() const { return callsign.data(); }
+    std::string_view getDestination() const { return destination.data(); }
+};
+
+// Shared MMSI-keyed table of AIS targets, sized for tens of thousands of vessels.
+// The table is split into shards with their own lock, so decoders on different
+// sources and readers (GUI, outputs) rarely contend.
+class AisTargetStore {
+public:
+    static constexpr size_t ShardCount = 64;
+    static constexpr size_t ExpectedTargets = 65536;
+    // Targets not heard for this long are dropped (expire(), run every ExpiryPeriod by the app).
+    // Above the 6 minute static report interval of moored and class B stations.
+    static constexpr std::chrono::minutes MaxTargetAge{20};
+    static constexpr std::chrono::seconds ExpiryPeriod{60};
+
+    static AisTargetStore& instance() {
+        static AisTargetStore instance;
+        return instance;
+    }
+
+    // Creates the target if needed and lets 'fn' update it under the shard lock
+    template<class F>
+    void update(uint32_t mmsi, F&& fn) {
+        Shard& shard = shardFor(mmsi);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        AisTarget& target = shard.targets[mmsi];
+        target.mmsi = mmsi;
+        fn(target);
+    }
+
+    std::optional<AisTarget> get(uint32_t mmsi) const;
+    std::vector<AisTarget> snapshot() const;
+    size_t size() const;
+
+    // Removes targets not heard since 'olderThan'. Returns the number removed.
+    size_t expire(std::chrono::system_clock::time_point olderThan);
+    void clear();
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint32_t, AisTarget> targets;
+    };
+
+    AisTargetStore();
+    AisTargetStore(const AisTargetStore&) = delete;
+    AisTargetStore& operator=(const AisTargetStore&) = delete;
+
+    // MMSIs are allocated by country (first 3 digits), mix them before picking a shard
+    Shard& shardFor(uint32_t mmsi) { return _shards[(mmsi * 2654435761u) >> 26]; }
+    const Shard& shardFor(uint32_t mmsi) const { return _shards[(mmsi * 2654435761u) >> 26]; }
+
+    std::unique_ptr<Shard[]> _shards;
+};
+
+} // namespace Core
@@ -0,0 +1,180 @@
+#include "AsyncSubscriber.hpp"
+#include <bit>
+#include <iostream>
+
+namespace Core {
+
+namespace {
+// Subscriber whose callback runs on this thread, if any
+thread_local const AsyncSubscriber* t_draining = nullptr;
+}
+
+AsyncSubscriber::AsyncSubscriber(Callback callback, ThreadPool& executor, QueuePolicy policy, size_t capacity)
+    : _callback(std::move(callback)), _executor(executor), _policy(policy) {
+    const size_t size = policy == QueuePolicy::Coalesce ? 1 : std::bit_ceil(capacity == 0 ? size_t(1) : capacity);
+    _cells.reset(new Cell[size]);
+    for (size_t i = 0; i < size; ++i) _cells[i].sequence.store(i, std::memory_order_relaxed);
+    _mask = size - 1;
+}
+
+bool AsyncSubscriber::tryPush(const CompactNavData& data) {
+    size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = _cells[pos & _mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.data = data;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Full
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncSubscriber::tryPop(CompactNavData& data) {
+    size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = _cells[pos & _mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                data = cell.data;
+                cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+                if (_policy == QueuePolicy::Block) {
+                    _popped.fetch_add(1, std::memory_order_release);
+                    _popped.notify_all();
+                }
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Empty
+        } else {
+            pos = _dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncSubscriber::hasPending() {
+    if (_policy == QueuePolicy::Coalesce) {
+        std::lock_guard<std::mutex> lock(_coalesceMutex);
+        return _hasCoalesced;
+    }
+    const size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    return _cells[pos & _mask].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+void AsyncSubscriber::push(const CompactNavData& data) {
+    if (_closed.load(std::memory_order_relaxed)) return;
+
+    switch (_policy) {
+    case QueuePolicy::Coalesce: {
+        std::lock_guard<std::mutex> lock(_coalesceMutex);
+        if (_hasCoalesced) {
+            _coalesced.merge(data);
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return; // Already scheduled
+        }
+        _coalesced = data;
+        _hasCoalesced = true;
+        break;
+    }
+    case QueuePolicy::Block:
+        for (;;) {
+            const uint32_t popped = _popped.load(std::memory_order_acquire);
+            if (tryPush(data)) break;
+            if (_closed.load(std::memory_order_acquire)) return;
+            _popped.wait(popped, std::memory_order_acquire);
+        }
+        break;
+    case QueuePolicy::DropOldest:
+        while (!tryPush(data)) {
+            CompactNavData oldest;
+            if (tryPop(oldest)) _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+    case QueuePolicy::DropNewest:
+        if (!tryPush(data)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        break;
+    }
+
+    // Pairs with the fence in drain(): either it sees this update, or we see it idle
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_scheduled.exchange(true, std::memory_order_acq_rel)) schedule();
+}
+
+void AsyncSubscriber::schedule() {
+    try {
+        _executor.post([self = shared_from_this()] { self->drain(); });
+    } catch (const std::exception& e) {
+        std::cerr << "AsyncSubscriber: " << e.what() << std::endl;
+        _scheduled.store(false);
+    }
+}
+
+void AsyncSubscriber::drain() {
+    _draining.store(true);
+    t_draining = this;
+
+    // Bounded batch, so one busy subscriber doesn't hold an executor thread forever
+    size_t batch = _mask + 1;
+    CompactNavData item;
+    while (!_closed.load() && batch-- > 0) {
+        if (_policy == QueuePolicy::Coalesce) {
+            std::lock_guard<std::mutex> lock(_coalesceMutex);
+            if (!_hasCoalesced) break;
+            item = _coalesced;
+            _hasCoalesced = false;
+        } else if (!tryPop(item)) {
+            break;
+        }
+        _callback(item);
+    }
+
+    t_draining = nullptr;
+    _draining.store(false);
+    _draining.notify_all();
+
+    if (!_closed.load() && hasPending()) {
+        schedule(); // Still scheduled: continue in a new task
+        return;
+    }
+    _scheduled.store(false);
+
+    // An update pushed since the check above may have seen us still scheduled
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_closed.load() && hasPending() && !_scheduled.exchange(true, std::memory_order_acq_rel)) schedule();
+}
+
+void AsyncSubscriber::close() {
+    _closed.store(true);
+
+    CompactNavData discarded;
+    while (tryPop(discarded)) {}
+    {
+        std::lock_guard<std::mutex> lock(_coalesceMutex);
+        _hasCoalesced = false;
+    }
+
+    // Wake blocked publishers
+    _popped.fetch_add(1, std::memory_order_release);
+    _popped.notify_all();
+
+    if (t_draining == this) return;
+    while (_draining.load()) _draining.wait(true);
+}
+
+uint64_t AsyncSubscriber::getDroppedCount() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace Core
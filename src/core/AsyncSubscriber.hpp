@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/CompactNavData.hpp"
+#include "core/ThreadPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Core {
+
+// What an asynchronous subscriber does when its queue is full
+enum class QueuePolicy {
+    Block,      // Publisher waits for room (executor must not be a publishing thread)
+    DropOldest, // Oldest pending update is discarded
+    DropNewest, // New update is discarded
+    Coalesce    // Single pending update, new updates are merged into it (CompactNavData::merge)
+};
+
+// Bounded queue of updates between publishers and one subscriber callback.
+// The callback runs on the executor, one update at a time, in publish order.
+//
+// The queue is a lock-free ring (bounded MPMC, per-cell sequence numbers): publishers and
+// the consumer never share a lock. Coalesce keeps its single update under a short lock,
+// as merging into it is a read-modify-write.
+class AsyncSubscriber : public std::enable_shared_from_this<AsyncSubscriber> {
+public:
+    using Callback = std::function<void(const CompactNavData&)>;
+
+    // 'capacity' is rounded up to a power of two
+    AsyncSubscriber(Callback callback, ThreadPool& executor, QueuePolicy policy, size_t capacity);
+
+    // Called from any publishing thread
+    void push(const CompactNavData& data);
+
+    // Drops pending updates and waits for a running callback to return
+    // (unless called from that callback)
+    void close();
+
+    uint64_t getDroppedCount() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        CompactNavData data;
+    };
+
+    bool tryPush(const CompactNavData& data);
+    bool tryPop(CompactNavData& data);
+    bool hasPending();
+
+    void schedule();
+    void drain();
+
+    Callback _callback;
+    ThreadPool& _executor;
+    QueuePolicy _policy;
+
+    // Ring, allocated once. Publishers that drop the oldest update pop it themselves,
+    // so both ends may have several threads.
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask = 0;
+    alignas(64) std::atomic<size_t> _enqueuePos{0};
+    alignas(64) std::atomic<size_t> _dequeuePos{0};
+    alignas(64) std::atomic<uint32_t> _popped{0}; // Blocked publishers wait on it
+
+    // Coalesce
+    std::mutex _coalesceMutex;
+    CompactNavData _coalesced;
+    bool _hasCoalesced = false;
+
+    std::atomic<bool> _scheduled{false}; // A drain task is queued or running
+    std::atomic<bool> _draining{false};
+    std::atomic<bool> _closed{false};
+
+    std::atomic<uint64_t> _dropped{0}; // Discarded (DropOldest, DropNewest) or merged (Coalesce) updates
+};
+
+} // namespace Core
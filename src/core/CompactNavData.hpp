@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/NavData.hpp"
+#include "core/SourceRegistry.hpp"
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+namespace Core {
+
+// Trivially copyable form of NavData carried by the MessageBus: interned source handle,
+// one availability bitmask, and two cache lines (header and the most used values first).
+// Plugins and the simulator keep using NavData, converted with fromNavData()/toNavData().
+struct alignas(64) CompactNavData {
+    int64_t timestampNs = 0; // system_clock, since epoch
+    SourceHandle source = SourceRegistry::NoSource;
+    NavFieldMask fields = 0;
+    bool isGpsValid = false;
+
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double speedOverGround = 0.0;
+    double courseOverGround = 0.0;
+    double heading = 0.0;
+    double windSpeed = 0.0;
+    double windAngle = 0.0;
+    double depth = 0.0;
+    double waterTemperature = 0.0;
+    double speedThroughWater = 0.0;
+    double altitude = 0.0;
+
+    bool has(NavFieldMask field) const { return (fields & field) != 0; }
+
+    std::chrono::system_clock::time_point timestamp() const {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timestampNs)));
+    }
+
+    void setTimestamp(std::chrono::system_clock::time_point time) {
+        timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    // Same semantics as NavData::merge
+    void merge(const CompactNavData& update) {
+        timestampNs = update.timestampNs;
+        source = update.source;
+        fields |= update.fields;
+
+        if (update.has(NavField::Position)) {
+            latitude = update.latitude;
+            longitude = update.longitude;
+            altitude = update.altitude;
+            isGpsValid = update.isGpsValid;
+        }
+        if (update.has(NavField::Speed)) {
+            speedOverGround = update.speedOverGround;
+            courseOverGround = update.courseOverGround;
+        }
+        if (update.has(NavField::Heading)) heading = update.heading;
+        if (update.has(NavField::Wind)) {
+            windSpeed = update.windSpeed;
+            windAngle = update.windAngle;
+        }
+        if (update.has(NavField::Depth)) depth = update.depth;
+        if (update.has(NavField::WaterTemperature)) waterTemperature = update.waterTemperature;
+        if (update.has(NavField::WaterSpeed)) speedThroughWater = update.speedThroughWater;
+    }
+
+    // 'source' overrides data.sourceId when the caller already holds a handle
+    static CompactNavData fromNavData(const NavData& data, SourceHandle source = SourceRegistry::NoSource) {
+        CompactNavData compact;
+        compact.setTimestamp(data.timestamp);
+        compact.source = source != SourceRegistry::NoSource || data.sourceId.empty()
+            ? source : SourceRegistry::instance().intern(data.sourceId);
+        compact.fields = data.fields();
+        compact.isGpsValid = data.isGpsValid;
+        compact.latitude = data.latitude;
+        compact.longitude = data.longitude;
+        compact.altitude = data.altitude;
+        compact.speedOverGround = data.speedOverGround;
+        compact.courseOverGround = data.courseOverGround;
+        compact.heading = data.heading;
+        compact.windSpeed = data.windSpeed;
+        compact.windAngle = data.windAngle;
+        compact.depth = data.depth;
+        compact.waterTemperature = data.waterTemperature;
+        compact.speedThroughWater = data.speedThroughWater;
+        return compact;
+    }
+
+    NavData toNavData() const {
+        NavData data;
+        data.timestamp = timestamp();
+        data.sourceId = SourceRegistry::instance().name(source);
+        data.isGpsValid = isGpsValid;
+        data.latitude = latitude;
+        data.longitude = longitude;
+        data.altitude = altitude;
+        data.speedOverGround = speedOverGround;
+        data.courseOverGround = courseOverGround;
+        data.heading = heading;
+        data.windSpeed = windSpeed;
+        data.windAngle = windAngle;
+        data.depth = depth;
+        data.waterTemperature = waterTemperature;
+        data.speedThroughWater = speedThroughWater;
+        data.hasPosition = has(NavField::Position);
+        data.hasSpeed = has(NavField::Speed);
+        data.hasHeading = has(NavField::Heading);
+        data.hasWind = has(NavField::Wind);
+        data.hasDepth = has(NavField::Depth);
+        data.hasWaterTemperature = has(NavField::WaterTemperature);
+        data.hasWaterSpeed = has(NavField::WaterSpeed);
+        return data;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<CompactNavData>, "CompactNavData is copied with memcpy semantics");
+static_assert(sizeof(CompactNavData) == 128, "CompactNavData should span exactly two cache lines");
+
+} // namespace Core
@@ -1,52 +1,183 @@
 #pragma once
 
 #include "core/NavData.hpp"
+#include "core/CompactNavData.hpp"
+#include "core/AsyncSubscriber.hpp"
+#include "core/ThreadPool.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
 #include <functional>
 #include <vector>
-#include <mutex>
 #include <map>
+#include <mutex>
 #include <memory>
+#include <thread>
+#include <utility>
 
 namespace Core {
 
+// Publish/subscribe hub for navigation updates, carried as CompactNavData.
+//
+// Listeners are kept in an immutable snapshot swapped atomically on subscribe/unsubscribe:
+// publishers (I/O threads) only load the current snapshot and never take the bus lock,
+// so subscribing or unsubscribing (which copies the listener lists) can't stall them.
+// Loading the snapshot is not wait-free though: libstdc++ and MSVC guard
+// std::atomic<std::shared_ptr> with an internal spinlock held for the pointer copy, and
+// every publish bumps the shared reference count. Concurrent publishers thus briefly
+// contend on that cache line, whatever the listeners.
+//
+// Listeners subscribed with a field mask sit in one list per NavField bit, and publish()
+// only walks the lists of the fields an update carries.
 class MessageBus {
 public:
     using ListenerId = size_t;
-    using Callback = std::function<void(const NavData&)>;
+    using Callback = std::function<void(const CompactNavData&)>;
+
+    // Subscription mask receiving every update, whatever its fields
+    static constexpr NavFieldMask AllUpdates = 0;
 
     static MessageBus& instance() {
         static MessageBus instance;
         return instance;
     }
 
-    ListenerId subscribe(Callback callback) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        ListenerId id = _nextId++;
-        _listeners[id] = callback;
+    // The callback runs synchronously on the publishing thread (serial/UDP I/O threads).
+    // With a mask (e.g. NavField::Wind | NavField::Heading), only updates carrying
+    // at least one of these fields are delivered, once each.
+    ListenerId subscribe(Callback callback, NavFieldMask fields = AllUpdates) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        return addListener(std::move(callback), fields);
+    }
+
+    // The callback runs on 'executor', fed by a bounded queue of 'capacity' updates:
+    // a slow consumer then delays nobody but itself. 'policy' decides what happens when it falls behind.
+    ListenerId subscribeAsync(Callback callback, ThreadPool& executor,
+                              QueuePolicy policy = QueuePolicy::DropOldest, size_t capacity = 256,
+                              NavFieldMask fields = AllUpdates) {
+        auto subscriber = std::make_shared<AsyncSubscriber>(std::move(callback), executor, policy, capacity);
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        ListenerId id = addListener([subscriber](const CompactNavData& data) { subscriber->push(data); }, fields);
+        _asyncSubscribers[id] = std::move(subscriber);
         return id;
     }
 
+    // Once this returns, the callback is not running anymore and will not be called again
+    // (except when called from inside a callback, which can't wait for itself).
     void unsubscribe(ListenerId id) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        _listeners.erase(id);
+        std::shared_ptr<const Callback> callback;
+        std::shared_ptr<AsyncSubscriber> subscriber;
+        {
+            std::lock_guard<std::mutex> lock(_writeMutex);
+            auto it = _asyncSubscribers.find(id);
+            if (it != _asyncSubscribers.end()) {
+                subscriber = std::move(it->second);
+                _asyncSubscribers.erase(it);
+            }
+
+            auto snapshot = std::make_shared<Snapshot>(*_snapshot.load(std::memory_order_acquire));
+            removeFrom(snapshot->all, id, callback);
+            for (auto& topic : snapshot->topics) {
+                removeFrom(topic, id, callback);
+            }
+            if (!callback) return;
+            _snapshot.store(std::move(snapshot), std::memory_order_release);
+            _listenerCount--;
+        }
+
+        // Every snapshot still holding the listener, however old, shares its callback: once
+        // ours is the last reference, no publisher can be iterating over it anymore
+        if (t_publishDepth == 0) {
+            while (callback.use_count() > 1) std::this_thread::yield();
+        }
+
+        // No more updates can be queued: drop the pending ones
+        if (subscriber) subscriber->close();
     }
 
+    // Legacy form (simulator, plugins): converted once, then published
     void publish(const NavData& data) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        for (const auto& [id, callback] : _listeners) {
-            callback(data);
+        publish(CompactNavData::fromNavData(data));
+    }
+
+    void publish(const CompactNavData& data) {
+        std::shared_ptr<const Snapshot> snapshot = _snapshot.load(std::memory_order_acquire);
+        ++t_publishDepth;
+        for (const auto& listener : snapshot->all) {
+            (*listener.callback)(data);
+        }
+
+        // A listener on several fields is called from the list of the lowest one the update carries
+        const NavFieldMask available = data.fields;
+        for (NavFieldMask pending = available; pending != 0; pending &= pending - 1) {
+            const int topic = std::countr_zero(pending);
+            const NavFieldMask lowerFields = (NavFieldMask(1) << topic) - 1;
+            for (const auto& listener : snapshot->topics[topic]) {
+                if ((listener.fields & available & lowerFields) == 0) (*listener.callback)(data);
+            }
         }
+        --t_publishDepth;
+    }
+
+    size_t getListenerCount() const {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        return _listenerCount;
     }
 
 private:
-    MessageBus() = default;
+    struct Listener {
+        ListenerId id;
+        NavFieldMask fields;
+        std::shared_ptr<const Callback> callback;
+    };
+    using ListenerList = std::vector<Listener>;
+
+    struct Snapshot {
+        ListenerList all; // Unfiltered subscriptions
+        std::array<ListenerList, NavField::Count> topics;
+    };
+
+    // Caller holds _writeMutex
+    ListenerId addListener(Callback callback, NavFieldMask fields) {
+        ListenerId id = _nextId++;
+        auto snapshot = std::make_shared<Snapshot>(*_snapshot.load(std::memory_order_acquire));
+        Listener listener{id, fields, std::make_shared<const Callback>(std::move(callback))};
+        if (fields == AllUpdates) {
+            snapshot->all.push_back(listener);
+        } else {
+            for (size_t topic = 0; topic < NavField::Count; ++topic) {
+                if (fields & (NavFieldMask(1) << topic)) snapshot->topics[topic].push_back(listener);
+            }
+        }
+        _snapshot.store(std::move(snapshot), std::memory_order_release);
+        _listenerCount++;
+        return id;
+    }
+
+    // Moves the callback of the removed listener to 'removed'
+    static void removeFrom(ListenerList& list, ListenerId id, std::shared_ptr<const Callback>& removed) {
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            if (it->id == id) {
+                removed = std::move(it->callback);
+                list.erase(it);
+                return;
+            }
+        }
+    }
+
+    MessageBus() : _snapshot(std::make_shared<const Snapshot>()) {}
     ~MessageBus() = default;
     MessageBus(const MessageBus&) = delete;
     MessageBus& operator=(const MessageBus&) = delete;
 
-    std::mutex _mutex;
-    std::map<ListenerId, Callback> _listeners;
+    // Nesting level of publish() on this thread
+    static inline thread_local int t_publishDepth = 0;
+
+    mutable std::mutex _writeMutex; // Serializes subscribe/unsubscribe only
+    std::atomic<std::shared_ptr<const Snapshot>> _snapshot;
+    std::map<ListenerId, std::shared_ptr<AsyncSubscriber>> _asyncSubscribers;
     ListenerId _nextId = 0;
+    size_t _listenerCount = 0;
 };
 
 } // namespace Core
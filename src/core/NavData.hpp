@@ -2,9 +2,26 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
 
 namespace Core {
 
+// Data groups carried by a NavData update, one bit per availability flag.
+// Used to subscribe to a subset of the updates (e.g. Wind | Heading).
+using NavFieldMask = uint32_t;
+
+namespace NavField {
+    constexpr NavFieldMask Position = 1u << 0;
+    constexpr NavFieldMask Speed = 1u << 1;
+    constexpr NavFieldMask Heading = 1u << 2;
+    constexpr NavFieldMask Wind = 1u << 3;
+    constexpr NavFieldMask Depth = 1u << 4;
+    constexpr NavFieldMask WaterTemperature = 1u << 5;
+    constexpr NavFieldMask WaterSpeed = 1u << 6;
+
+    constexpr size_t Count = 7;
+} // namespace NavField
+
 struct NavData {
     // Timestamp of the data
     std::chrono::system_clock::time_point timestamp;
@@ -44,6 +61,62 @@ struct NavData {
     bool hasHeading = false;
     bool hasWaterTemperature = false;
     bool hasWaterSpeed = false;
+
+    NavFieldMask fields() const {
+        return (hasPosition ? NavField::Position : 0) |
+               (hasSpeed ? NavField::Speed : 0) |
+               (hasHeading ? NavField::Heading : 0) |
+               (hasWind ? NavField::Wind : 0) |
+               (hasDepth ? NavField::Depth : 0) |
+               (hasWaterTemperature ? NavField::WaterTemperature : 0) |
+               (hasWaterSpeed ? NavField::WaterSpeed : 0);
+    }
+
+    // Applies a partial update: only the groups flagged as available in 'update' are copied
+    void merge(const NavData& update) {
+        timestamp = update.timestamp;
+        sourceId = update.sourceId;
+
+        if (update.hasPosition) {
+            latitude = update.latitude;
+            longitude = update.longitude;
+            altitude = update.altitude;
+            isGpsValid = update.isGpsValid;
+            hasPosition = true;
+        }
+
+        if (update.hasSpeed) {
+            speedOverGround = update.speedOverGround;
+            courseOverGround = update.courseOverGround;
+            hasSpeed = true;
+        }
+
+        if (update.hasHeading) {
+            heading = update.heading;
+            hasHeading = true;
+        }
+
+        if (update.hasWind) {
+            windSpeed = update.windSpeed;
+            windAngle = update.windAngle;
+            hasWind = true;
+        }
+
+        if (update.hasDepth) {
+            depth = update.depth;
+            hasDepth = true;
+        }
+
+        if (update.hasWaterTemperature) {
+            waterTemperature = update.waterTemperature;
+            hasWaterTemperature = true;
+        }
+
+        if (update.hasWaterSpeed) {
+            speedThroughWater = update.speedThroughWater;
+            hasWaterSpeed = true;
+        }
+    }
 };
 
 } // namespace Core
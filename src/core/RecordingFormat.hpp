@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// On-disk format of NavOne recordings (App::Recorder), read back by replay and batch tools.
+//
+// A recording is a directory of segment files "navone-<date>-<time>-<n>.nvr":
+//
+//   SegmentHeader
+//   RecordHeader + payload, repeated (payload: sentence without CR/LF, or a source name)
+//   IndexEntry[indexCount]   (written when the segment is closed)
+//   SegmentTrailer
+//
+// Timestamps are steady clock nanoseconds, converted to wall time with the two clocks
+// sampled in the header. Source handles are only valid within their segment: a SourceName
+// record defines each handle before its first sentence. A segment without a trailer
+// (crash, power loss) is still readable record by record up to its last complete one.
+// Integers are little-endian, as on every platform NavOne runs on.
+namespace Core::Recording {
+
+constexpr char SegmentMagic[8] = {'N', 'A', 'V', 'R', 'E', 'C', '0', '1'};
+constexpr char TrailerMagic[8] = {'N', 'A', 'V', 'I', 'D', 'X', '0', '1'};
+constexpr uint32_t Version = 1;
+constexpr const char* Extension = ".nvr";
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize; // Offset of the first record
+    int64_t wallClockNs; // system_clock and steady_clock sampled together at segment open
+    int64_t monotonicNs;
+};
+
+enum class RecordType : uint8_t {
+    Sentence = 1,
+    SourceName = 2 // Payload: name of 'source' (e.g. "UDP:GPS"), timestamp unused
+};
+
+struct RecordHeader {
+    int64_t timestampNs; // Receive time
+    uint32_t length;     // Payload bytes following this header
+    uint16_t source;
+    uint8_t type;        // RecordType
+    uint8_t reserved;
+};
+
+// Sparse time index: first record at or after each IndexInterval boundary
+struct IndexEntry {
+    int64_t timestampNs;
+    uint64_t offset; // Of its RecordHeader, from the start of the file
+};
+
+struct SegmentTrailer {
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t recordCount; // Sentences
+    int64_t firstTimestampNs;
+    int64_t lastTimestampNs;
+    char magic[8];
+};
+
+static_assert(sizeof(SegmentHeader) == 32, "SegmentHeader layout");
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader layout");
+static_assert(sizeof(IndexEntry) == 16, "IndexEntry layout");
+static_assert(sizeof(SegmentTrailer) == 48, "SegmentTrailer layout");
+
+inline bool hasMagic(const char (&magic)[8], const char (&expected)[8]) {
+    return std::memcmp(magic, expected, sizeof(expected)) == 0;
+}
+
+} // namespace Core::Recording
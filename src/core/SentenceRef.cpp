@@ -0,0 +1,127 @@
+#include "SentenceRef.hpp"
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace Core {
+
+namespace {
+
+constexpr size_t LocalCacheSize = 256;
+constexpr size_t TransferBatch = 64;
+
+// Free blocks are raw memory, their first word links to the next one
+void*& link(void* block) { return *static_cast<void**>(block); }
+
+// Shared free list. Threads exchange blocks with it in batches: ingest threads
+// mostly allocate, output threads mostly release.
+struct SharedPool {
+    std::mutex mutex;
+    void* head = nullptr;
+};
+
+// Never destroyed: blocks may be released by threads exiting after main()
+SharedPool& sharedPool() {
+    static SharedPool* pool = new SharedPool();
+    return *pool;
+}
+
+struct LocalCache {
+    void* head = nullptr;
+    size_t count = 0;
+
+    ~LocalCache() {
+        while (head) spill(TransferBatch);
+    }
+
+    void* pop() {
+        if (!head && !refill()) return nullptr;
+        void* block = head;
+        head = link(block);
+        count--;
+        return block;
+    }
+
+    void push(void* block) {
+        link(block) = head;
+        head = block;
+        if (++count > LocalCacheSize) spill(TransferBatch);
+    }
+
+    bool refill() {
+        SharedPool& pool = sharedPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        for (size_t i = 0; i < TransferBatch && pool.head; ++i) {
+            void* block = pool.head;
+            pool.head = link(block);
+            link(block) = head;
+            head = block;
+            count++;
+        }
+        return head != nullptr;
+    }
+
+    // Moves up to 'n' blocks to the shared pool
+    void spill(size_t n) {
+        void* first = head;
+        void* last = head;
+        size_t moved = 1;
+        while (moved < n && link(last)) {
+            last = link(last);
+            moved++;
+        }
+        head = link(last);
+        count -= moved;
+
+        SharedPool& pool = sharedPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        link(last) = pool.head;
+        pool.head = first;
+    }
+};
+
+thread_local LocalCache t_cache;
+
+} // namespace
+
+SentenceRef SentenceRef::make(std::string_view sentence) {
+    SentenceRef ref;
+    ref._block = acquire(sentence.size() + 2);
+    char* data = ref._block->data();
+    std::memcpy(data, sentence.data(), sentence.size());
+    data[sentence.size()] = '\r';
+    data[sentence.size() + 1] = '\n';
+    ref._block->length = static_cast<uint32_t>(sentence.size() + 2);
+    return ref;
+}
+
+SentenceRef::Block* SentenceRef::acquire(size_t length) {
+    size_t capacity = PooledCapacity;
+    void* memory = nullptr;
+
+    if (length > PooledCapacity) {
+        capacity = length;
+    } else {
+        memory = t_cache.pop();
+    }
+    if (!memory) memory = ::operator new(sizeof(Block) + capacity);
+
+    Block* block = new (memory) Block;
+    block->refs.store(1, std::memory_order_relaxed);
+    block->length = 0;
+    block->capacity = static_cast<uint32_t>(capacity);
+    return block;
+}
+
+void SentenceRef::release(Block* block) {
+    bool pooled = block->capacity == PooledCapacity;
+    block->~Block();
+
+    if (pooled) {
+        t_cache.push(block);
+    } else {
+        ::operator delete(block);
+    }
+}
+
+} // namespace Core
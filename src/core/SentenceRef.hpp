@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace Core {
+
+// Immutable NMEA sentence shared by reference count, stored with its CR/LF terminator.
+//
+// Built once when a sentence is received, then handed unchanged to the parser, every
+// output queue and the logger: fanning it out to N outputs costs N refcount increments.
+// Buffers come from a pool (per-thread caches over a shared free list).
+class SentenceRef {
+public:
+    SentenceRef() = default;
+    ~SentenceRef() { reset(); }
+
+    SentenceRef(const SentenceRef& other) : _block(other._block) {
+        if (_block) _block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    SentenceRef(SentenceRef&& other) noexcept : _block(std::exchange(other._block, nullptr)) {}
+
+    SentenceRef& operator=(SentenceRef other) noexcept {
+        std::swap(_block, other._block);
+        return *this;
+    }
+
+    // Copies 'sentence' (without terminator) and appends CR/LF
+    static SentenceRef make(std::string_view sentence);
+
+    // With CR/LF: what goes on the wire
+    std::string_view line() const {
+        return _block ? std::string_view(_block->data(), _block->length) : std::string_view();
+    }
+
+    // Without CR/LF
+    std::string_view sentence() const {
+        return _block ? std::string_view(_block->data(), _block->length - 2) : std::string_view();
+    }
+
+    explicit operator bool() const { return _block != nullptr; }
+
+    void reset() {
+        if (_block && _block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) release(_block);
+        _block = nullptr;
+    }
+
+    // Blocks up to this size are pooled, longer sentences are allocated on their own
+    static constexpr size_t PooledCapacity = 96; // NMEA 0183: 82 chars max, with CR/LF
+
+private:
+    struct Block {
+        std::atomic<uint32_t> refs;
+        uint32_t length;
+        uint32_t capacity;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static Block* acquire(size_t length);
+    static void release(Block* block);
+
+    Block* _block = nullptr;
+};
+
+} // namespace Core
@@ -0,0 +1,29 @@
+#include "SourceRegistry.hpp"
+#include <iostream>
+
+namespace Core {
+
+SourceRegistry::SourceRegistry() {
+    _names.emplace_back();
+    _handles.emplace(_names.back(), NoSource);
+    _byHandle[NoSource].store(&_names.back(), std::memory_order_release);
+}
+
+SourceHandle SourceRegistry::intern(std::string_view name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _handles.find(name);
+    if (it != _handles.end()) return it->second;
+
+    if (_names.size() >= MaxSources) {
+        std::cerr << "SourceRegistry: too many sources, ignoring " << name << std::endl;
+        return NoSource;
+    }
+
+    SourceHandle handle = static_cast<SourceHandle>(_names.size());
+    _names.emplace_back(name);
+    _handles.emplace(_names.back(), handle);
+    _byHandle[handle].store(&_names.back(), std::memory_order_release);
+    return handle;
+}
+
+} // namespace Core
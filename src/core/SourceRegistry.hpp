@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Core {
+
+using SourceHandle = uint32_t;
+
+// Interns source names ("SERIAL:GPS", "SIMULATOR"...) into small handles, so data
+// records carry 4 bytes instead of a string. Handles are never released.
+class SourceRegistry {
+public:
+    static constexpr SourceHandle NoSource = 0; // Name ""
+    static constexpr size_t MaxSources = 4096;
+
+    static SourceRegistry& instance() {
+        static SourceRegistry instance;
+        return instance;
+    }
+
+    // Returns the handle of 'name', registering it on first use.
+    // Past MaxSources, new names map to NoSource.
+    SourceHandle intern(std::string_view name);
+
+    // Lock-free. Unknown handles give an empty name.
+    const std::string& name(SourceHandle handle) const {
+        // Not _names[NoSource]: intern() may be growing the deque meanwhile
+        static const std::string empty;
+        if (handle >= MaxSources) return empty;
+        const std::string* name = _byHandle[handle].load(std::memory_order_acquire);
+        return name ? *name : empty;
+    }
+
+private:
+    SourceRegistry();
+    SourceRegistry(const SourceRegistry&) = delete;
+    SourceRegistry& operator=(const SourceRegistry&) = delete;
+
+    std::mutex _mutex;
+    std::deque<std::string> _names; // Stable addresses
+    std::unordered_map<std::string_view, SourceHandle> _handles; // Views into _names
+    std::array<std::atomic<const std::string*>, MaxSources> _byHandle{};
+};
+
+} // namespace Core
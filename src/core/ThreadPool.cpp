@@ -1,41 +1,170 @@
 #include "ThreadPool.hpp"
+#include <iostream>
 
 namespace Core {
 
+namespace {
+
+// Pool and worker index of the current thread, to push to the local deque
+thread_local const void* t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+} // namespace
+
+bool ThreadPool::WorkDeque::push(Task* task) {
+    int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    int64_t top = _top.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity) return false;
+
+    _buffer[bottom & (Capacity - 1)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+ThreadPool::Task* ThreadPool::WorkDeque::pop() {
+    int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = _buffer[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // Last item: race against thieves
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+ThreadPool::Task* ThreadPool::WorkDeque::steal() {
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) return nullptr;
+
+    Task* task = _buffer[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr; // Lost the race, the caller moves on
+    }
+    return task;
+}
+
 ThreadPool::ThreadPool(size_t numThreads) : _stop(false), _busyThreads(0) {
+    if (numThreads == 0) numThreads = 1;
     for(size_t i = 0; i < numThreads; ++i) {
-        _workers.emplace_back([this] {
-            for(;;) {
-                std::function<void()> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(this->_queueMutex);
-                    this->_condition.wait(lock, [this]{ return this->_stop || !this->_tasks.empty(); });
-                    
-                    if(this->_stop && this->_tasks.empty())
-                        return;
-                    
-                    task = std::move(this->_tasks.front());
-                    this->_tasks.pop();
-                }
-
-                this->_busyThreads++;
-                task();
-                this->_busyThreads--;
-            }
-        });
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // Start threads once every deque exists, they steal from each other
+    for(size_t i = 0; i < numThreads; ++i) {
+        _workers[i]->thread = std::thread([this, i] { workerLoop(i); });
     }
 }
 
 ThreadPool::~ThreadPool() {
     {
-        std::unique_lock<std::mutex> lock(_queueMutex);
+        std::unique_lock<std::mutex> lock(_sleepMutex);
         _stop = true;
     }
     _condition.notify_all();
-    for(std::thread &worker: _workers) {
-        if(worker.joinable())
-            worker.join();
+    for(auto& worker: _workers) {
+        if(worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+bool ThreadPool::acceptsTasks() const {
+    // A pool thread only submits from a running task, which keeps _pending above zero:
+    // the workers can't have left yet
+    return !_stop || t_pool == this;
+}
+
+void ThreadPool::submit(Task* task) {
+    // Counted before a worker can take it, so the counters never go below zero
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    _queued.fetch_add(1, std::memory_order_seq_cst);
+
+    if (t_pool == this) {
+        if (!_workers[t_workerIndex]->deque.push(task)) {
+            // Local deque full
+            std::lock_guard<std::mutex> lock(_injectionMutex);
+            _injection.push_back(task);
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        _injection.push_back(task);
+    }
+
+    // Pairs with the sleeper check in workerLoop: either we see a sleeper, or it sees the task
+    if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(_sleepMutex); }
+        _condition.notify_one();
+    }
+}
+
+ThreadPool::Task* ThreadPool::findTask(size_t self) {
+    if (Task* task = _workers[self]->deque.pop()) return task;
+
+    {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        if (!_injection.empty()) {
+            Task* task = _injection.front();
+            _injection.pop_front();
+            return task;
+        }
+    }
+
+    const size_t count = _workers.size();
+    for (size_t i = 1; i < count; ++i) {
+        if (Task* task = _workers[(self + i) % count]->deque.steal()) return task;
+    }
+    return nullptr;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    t_pool = this;
+    t_workerIndex = index;
+
+    for(;;) {
+        Task* task = findTask(index);
+        if (task) {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            _busyThreads++;
+            try {
+                task->run();
+            } catch (const std::exception& e) {
+                std::cerr << "ThreadPool: task failed: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "ThreadPool: task failed" << std::endl;
+            }
+            delete task;
+            _busyThreads--;
+
+            // A running task may still submit more: workers leave once none is left
+            if (_pending.fetch_sub(1, std::memory_order_seq_cst) == 1 && _stop) {
+                { std::lock_guard<std::mutex> lock(_sleepMutex); }
+                _condition.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        if (_stop && _pending.load() == 0)
+            return;
+
+        _sleepers.fetch_add(1, std::memory_order_seq_cst);
+        _condition.wait(lock, [this] {
+            return _queued.load(std::memory_order_seq_cst) > 0 || (_stop && _pending.load() == 0);
+        });
+        _sleepers.fetch_sub(1, std::memory_order_relaxed);
     }
 }
 
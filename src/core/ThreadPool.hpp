@@ -1,16 +1,24 @@
 #pragma once
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 
 namespace Core {
 
+// Work-stealing thread pool.
+//
+// Each worker owns a bounded lock-free deque (Chase-Lev): tasks submitted from a worker
+// go to its own deque and are popped LIFO, idle workers steal FIFO from the others.
+// Tasks submitted from other threads go through a global injection queue.
 class ThreadPool {
 public:
     explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
@@ -20,18 +28,71 @@ public:
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
 
+    // Fire-and-forget: no future, a single allocation per task.
+    // Once the pool is stopping, only its own tasks may still submit (their work is run before
+    // the workers exit); other threads get std::runtime_error.
+    template<class F>
+    void post(F&& f);
+
     // Get the number of busy threads (approximate)
     size_t getBusyCount() const;
-    
+
     // Get total number of threads
     size_t getThreadCount() const;
 
 private:
-    std::vector<std::thread> _workers;
-    std::queue<std::function<void()>> _tasks;
-    
-    std::mutex _queueMutex;
+    struct Task {
+        virtual ~Task() = default;
+        virtual void run() = 0;
+    };
+
+    template<class F>
+    struct TaskImpl final : Task {
+        explicit TaskImpl(F&& f) : fn(std::move(f)) {}
+        void run() override { fn(); }
+        F fn;
+    };
+
+    // Single producer (owner) / multiple consumers (thieves), fixed capacity
+    class WorkDeque {
+    public:
+        static constexpr int64_t Capacity = 4096; // Power of two
+
+        WorkDeque() : _buffer(new std::atomic<Task*>[Capacity]) {}
+
+        bool push(Task* task);
+        Task* pop();
+        Task* steal();
+
+    private:
+        alignas(64) std::atomic<int64_t> _top{0};
+        alignas(64) std::atomic<int64_t> _bottom{0};
+        std::unique_ptr<std::atomic<Task*>[]> _buffer;
+    };
+
+    struct alignas(64) Worker {
+        WorkDeque deque;
+        std::thread thread;
+    };
+
+    bool acceptsTasks() const;
+    void submit(Task* task);
+    Task* findTask(size_t self);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Injection queue, for tasks submitted from outside the pool
+    std::mutex _injectionMutex;
+    std::deque<Task*> _injection;
+
+    // Sleeping workers
+    std::mutex _sleepMutex;
     std::condition_variable _condition;
+    std::atomic<size_t> _queued{0};   // Submitted, not yet taken
+    std::atomic<size_t> _pending{0};  // Submitted, not yet finished
+    std::atomic<size_t> _sleepers{0};
+
     std::atomic<bool> _stop;
     std::atomic<size_t> _busyThreads;
 };
@@ -41,22 +102,21 @@ template<class F, class... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
     using return_type = typename std::invoke_result<F, Args...>::type;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+    std::packaged_task<return_type()> task(
+        [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable { return std::invoke(f, args...); }
     );
+    std::future<return_type> res = task.get_future();
+    post(std::move(task));
+    return res;
+}
 
-    std::future<return_type> res = task->get_future();
-    {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-
-        // Don't allow enqueueing after stopping
-        if(_stop)
-            throw std::runtime_error("enqueue on stopped ThreadPool");
+template<class F>
+void ThreadPool::post(F&& f) {
+    // Don't allow enqueueing after stopping, except from tasks being drained
+    if (!acceptsTasks())
+        throw std::runtime_error("enqueue on stopped ThreadPool");
 
-        _tasks.emplace([task](){ (*task)(); });
-    }
-    _condition.notify_one();
-    return res;
+    submit(new TaskImpl<std::decay_t<F>>(std::decay_t<F>(std::forward<F>(f))));
 }
 
 } // namespace Core
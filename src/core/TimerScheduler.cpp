@@ -0,0 +1,146 @@
+#include "TimerScheduler.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+namespace Core {
+
+TimerScheduler::TimerScheduler() {
+    _thread = std::thread([this] { run(); });
+}
+
+TimerScheduler::~TimerScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    if (_thread.joinable()) _thread.join();
+}
+
+TimerScheduler::TimerId TimerScheduler::scheduleAfter(Duration delay, Callback callback, Duration slack) {
+    return add(Clock::now() + delay, Duration::zero(), slack, std::move(callback));
+}
+
+TimerScheduler::TimerId TimerScheduler::schedulePeriodic(Duration period, Callback callback, Duration slack) {
+    if (period <= Duration::zero()) return InvalidTimer;
+    return add(Clock::now() + period, period, slack, std::move(callback));
+}
+
+TimerScheduler::TimerId TimerScheduler::add(Clock::time_point deadline, Duration period, Duration slack, Callback callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    TimerId id = _nextId++;
+    _heap.push_back(Timer{id, deadline, deadline + slack, period, slack, std::move(callback)});
+    std::push_heap(_heap.begin(), _heap.end(), LaterFirst());
+
+    // Wake the thread if this timer is now the first one
+    if (_heap.front().id == id) _condition.notify_one();
+    return id;
+}
+
+bool TimerScheduler::cancel(TimerId id) {
+    if (id == InvalidTimer) return false;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = std::find_if(_heap.begin(), _heap.end(), [id](const Timer& timer) { return timer.id == id; });
+    if (it != _heap.end()) {
+        _heap.erase(it);
+        std::make_heap(_heap.begin(), _heap.end(), LaterFirst());
+        return true;
+    }
+
+    if (_runningId == id) {
+        _cancelRunning = true;
+        if (std::this_thread::get_id() != _thread.get_id()) {
+            _callbackDone.wait(lock, [this, id] { return _runningId != id; });
+        }
+        return true;
+    }
+
+    // Due in the current wakeup, but not run yet
+    for (auto& timer : _due) {
+        if (timer.id == id) {
+            timer.id = InvalidTimer;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t TimerScheduler::getTimerCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = _heap.size();
+    for (const auto& timer : _due) {
+        if (timer.id != InvalidTimer) count++;
+    }
+    return count;
+}
+
+uint64_t TimerScheduler::getWakeupCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _wakeups;
+}
+
+void TimerScheduler::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_stop) {
+        if (_heap.empty()) {
+            _condition.wait(lock);
+            continue;
+        }
+
+        Clock::time_point wakeAt = _heap.front().latest;
+        if (Clock::now() < wakeAt) {
+            _condition.wait_until(lock, wakeAt);
+            continue; // Timers may have changed meanwhile
+        }
+        _wakeups++;
+
+        // Coalescing: run every timer already due, not only those out of slack
+        Clock::time_point now = Clock::now();
+        auto firstLater = std::partition(_heap.begin(), _heap.end(),
+                                         [now](const Timer& timer) { return timer.deadline > now; });
+        _due.assign(std::make_move_iterator(firstLater), std::make_move_iterator(_heap.end()));
+        _heap.erase(firstLater, _heap.end());
+        std::make_heap(_heap.begin(), _heap.end(), LaterFirst());
+        std::sort(_due.begin(), _due.end(), [](const Timer& a, const Timer& b) { return a.deadline < b.deadline; });
+
+        for (auto& timer : _due) {
+            if (timer.id == InvalidTimer) continue; // Cancelled meanwhile
+            _runningId = timer.id;
+            _cancelRunning = false;
+            lock.unlock();
+
+            try {
+                timer.callback();
+            } catch (const std::exception& e) {
+                std::cerr << "Timer callback failed: " << e.what() << std::endl;
+            }
+
+            lock.lock();
+            bool cancelled = _cancelRunning;
+            TimerId id = timer.id;
+            timer.id = InvalidTimer; // Done with this wakeup
+            _runningId = InvalidTimer;
+            _callbackDone.notify_all();
+
+            if (timer.period > Duration::zero() && !cancelled && !_stop) {
+                timer.id = id;
+                // Drift-free: stay on the original grid, skipping missed periods
+                timer.deadline += timer.period;
+                Clock::time_point current = Clock::now();
+                if (timer.deadline <= current) {
+                    auto missed = (current - timer.deadline) / timer.period + 1;
+                    timer.deadline += missed * timer.period;
+                }
+                timer.latest = timer.deadline + timer.slack;
+                _heap.push_back(std::move(timer));
+                std::push_heap(_heap.begin(), _heap.end(), LaterFirst());
+            }
+        }
+        _due.clear();
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core {
+
+// One thread running every timed task of the application (simulator tick, output pacing,
+// watchdogs, stats flushes) instead of sleep loops each holding a worker.
+//
+// Timers are kept in a deadline heap. Periodic timers are drift-free: the next deadline is
+// the previous one plus the period, not "now" plus the period. A timer may accept some
+// slack: the thread then wakes once for all timers due in the same window.
+//
+// Callbacks run on the timer thread and must stay short: post heavier work to a ThreadPool.
+class TimerScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = Clock::duration;
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId InvalidTimer = 0;
+
+    static TimerScheduler& instance() {
+        static TimerScheduler instance;
+        return instance;
+    }
+
+    TimerId scheduleAfter(Duration delay, Callback callback, Duration slack = Duration::zero());
+
+    // First run after one period. Missed periods (callback too slow, system suspended) are skipped.
+    TimerId schedulePeriodic(Duration period, Callback callback, Duration slack = Duration::zero());
+
+    // Once this returns, the callback is not running and won't run again
+    // (except when cancelling a timer from its own callback).
+    bool cancel(TimerId id);
+
+    size_t getTimerCount() const;
+    uint64_t getWakeupCount() const;
+
+private:
+    struct Timer {
+        TimerId id;
+        Clock::time_point deadline;
+        Clock::time_point latest; // deadline + slack
+        Duration period;          // Zero for one-shot timers
+        Duration slack;
+        Callback callback;
+    };
+
+    // Min-heap on 'latest': the top is the next time the thread must wake up
+    struct LaterFirst {
+        bool operator()(const Timer& a, const Timer& b) const { return a.latest > b.latest; }
+    };
+
+    TimerScheduler();
+    ~TimerScheduler();
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+    TimerId add(Clock::time_point deadline, Duration period, Duration slack, Callback callback);
+    void run();
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::condition_variable _callbackDone;
+    std::vector<Timer> _heap;
+    std::vector<Timer> _due; // Timers of the current wakeup, run in deadline order
+    TimerId _nextId = 1;
+    TimerId _runningId = InvalidTimer;
+    bool _cancelRunning = false; // The running timer was cancelled, don't reschedule it
+    bool _stop = false;
+    uint64_t _wakeups = 0;
+    std::thread _thread;
+};
+
+} // namespace Core
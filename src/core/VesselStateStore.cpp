@@ -0,0 +1,60 @@
+#include "VesselStateStore.hpp"
+#include <cstring>
+#include <thread>
+
+namespace Core {
+
+static_assert(sizeof(CompactNavData) % sizeof(uint64_t) == 0, "CompactNavData is copied as 64-bit words");
+
+VesselStateStore::VesselStateStore() {
+    publish();
+}
+
+void VesselStateStore::merge(const CompactNavData& update) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    _state.merge(update);
+    publish();
+}
+
+void VesselStateStore::reset() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    _state = CompactNavData{};
+    publish();
+}
+
+void VesselStateStore::publish() {
+    uint64_t words[WordCount];
+    std::memcpy(words, &_state, sizeof(words));
+
+    uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WordCount; ++i) {
+        _words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+CompactNavData VesselStateStore::snapshot() const {
+    uint64_t words[WordCount];
+    for (unsigned attempt = 0;; ++attempt) {
+        uint64_t before = _sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            for (size_t i = 0; i < WordCount; ++i) {
+                words[i] = _words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_sequence.load(std::memory_order_relaxed) == before) break;
+        }
+        // A write is in progress: it only takes a few stores, unless the writer was preempted
+        if (attempt > 64) std::this_thread::yield();
+    }
+
+    CompactNavData state;
+    std::memcpy(&state, words, sizeof(words));
+    return state;
+}
+
+} // namespace Core
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/CompactNavData.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace Core {
+
+// Latest fused state of our own vessel, merged from every partial update.
+//
+// Readers (GUI render, headless loop, output servers) take consistent snapshots through
+// a seqlock: they retry if a write overlapped, and never block writers. Writers only
+// serialize among themselves.
+class VesselStateStore {
+public:
+    static VesselStateStore& instance() {
+        static VesselStateStore instance;
+        return instance;
+    }
+
+    // Merges the fields carried by 'update' (CompactNavData::merge)
+    void merge(const CompactNavData& update);
+
+    CompactNavData snapshot() const;
+
+    // Incremented by each merge: readers can skip work when nothing changed
+    uint64_t version() const { return _sequence.load(std::memory_order_acquire) / 2; }
+
+    void reset();
+
+private:
+    static constexpr size_t WordCount = sizeof(CompactNavData) / sizeof(uint64_t);
+
+    VesselStateStore();
+    VesselStateStore(const VesselStateStore&) = delete;
+    VesselStateStore& operator=(const VesselStateStore&) = delete;
+
+    void publish(); // Caller holds _writeMutex
+
+    std::mutex _writeMutex;
+    CompactNavData _state; // Writer-side copy, under _writeMutex
+
+    // Odd while a write is in progress
+    alignas(64) std::atomic<uint64_t> _sequence{0};
+    alignas(64) std::array<std::atomic<uint64_t>, WordCount> _words;
+};
+
+} // namespace Core
@@ -1,11 +1,41 @@
 #include "CommunicationSettingsWindow.hpp"
 #include "utils/SerialPortUtils.hpp"
+#include "network/ReplayService.hpp"
 #include <chrono>
 #include <string>
 #include <algorithm>
 
 namespace Gui {
 
+namespace {
+
+// Sentence pattern lists are edited as "GPRMC, *GSV, ..."
+std::string joinPatterns(const std::vector<std::string>& patterns) {
+    std::string text;
+    for (const auto& pattern : patterns) {
+        if (!text.empty()) text += ", ";
+        text += pattern;
+    }
+    return text;
+}
+
+std::vector<std::string> splitPatterns(const char* text) {
+    std::vector<std::string> patterns;
+    std::string current;
+    for (const char* c = text; ; ++c) {
+        if (*c == ',' || *c == '\0') {
+            if (!current.empty()) patterns.push_back(current);
+            current.clear();
+            if (*c == '\0') break;
+        } else if (*c != ' ') {
+            current += *c;
+        }
+    }
+    return patterns;
+}
+
+} // namespace
+
 CommunicationSettingsWindow::CommunicationSettingsWindow(App::ServiceManager& manager) 
     : _serviceManager(manager) {}
 
@@ -74,7 +104,7 @@ void CommunicationSettingsWindow::render() {
                     }
 
                     // Source Type Combo
-                    const char* types[] = { "Serial", "UDP", "Simulator" };
+                    const char* types[] = { "Serial", "UDP", "Simulator", "TCP Client", "Replay" };
                     int currentType = (int)config.type;
                     if (ImGui::Combo("Type", &currentType, types, IM_ARRAYSIZE(types))) {
                         config.type = (App::SourceType)currentType;
@@ -125,6 +155,94 @@ void CommunicationSettingsWindow::render() {
                         if (ImGui::InputInt("Port", &config.port)) {
                             if (config.enabled) _serviceManager.updateServiceState(config);
                         }
+
+                        char groupBuf[64];
+                        strncpy(groupBuf, config.multicastGroup.c_str(), sizeof(groupBuf) - 1);
+                        groupBuf[sizeof(groupBuf) - 1] = '\0';
+                        if (ImGui::InputText("Multicast Group", groupBuf, sizeof(groupBuf))) {
+                            config.multicastGroup = groupBuf;
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+
+                        char interfaceBuf[64];
+                        strncpy(interfaceBuf, config.interfaceAddress.c_str(), sizeof(interfaceBuf) - 1);
+                        interfaceBuf[sizeof(interfaceBuf) - 1] = '\0';
+                        if (ImGui::InputText("Interface Address", interfaceBuf, sizeof(interfaceBuf))) {
+                            config.interfaceAddress = interfaceBuf;
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+
+                        char filterBuf[64];
+                        strncpy(filterBuf, config.sourceFilter.c_str(), sizeof(filterBuf) - 1);
+                        filterBuf[sizeof(filterBuf) - 1] = '\0';
+                        if (ImGui::InputText("Accept Only From", filterBuf, sizeof(filterBuf))) {
+                            config.sourceFilter = filterBuf;
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+
+                        if (ImGui::Checkbox("Share Port With Other Programs", &config.sharedPort)) {
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+                        if (ImGui::InputInt("Receivers", &config.udpReceivers)) {
+                            config.udpReceivers = std::clamp(config.udpReceivers, 1, 16);
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+                        if (config.udpReceivers > 1 && (config.sharedPort || !config.multicastGroup.empty())) {
+                            ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Several receivers need a unicast, unshared port: one is used.");
+                        }
+                        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Empty addresses: any. Shared ports: broadcast and multicast reach every program.");
+                    } else if (config.type == App::SourceType::TcpClient) {
+                        char hostBuf[128];
+                        strncpy(hostBuf, config.address.c_str(), sizeof(hostBuf) - 1);
+                        hostBuf[sizeof(hostBuf) - 1] = '\0';
+                        if (ImGui::InputText("Host", hostBuf, sizeof(hostBuf))) {
+                            config.address = hostBuf;
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+                        if (ImGui::InputInt("Port", &config.port)) {
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+                    } else if (config.type == App::SourceType::Replay) {
+                        char pathBuf[512];
+                        strncpy(pathBuf, config.replayPath.c_str(), sizeof(pathBuf) - 1);
+                        pathBuf[sizeof(pathBuf) - 1] = '\0';
+                        if (ImGui::InputText("Log Path", pathBuf, sizeof(pathBuf))) {
+                            config.replayPath = pathBuf;
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+                        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Recording directory, .nvr segment or NMEA text log.");
+
+                        Network::ReplayService* replay = _serviceManager.getReplay(config.id);
+
+                        // Speed and seeking apply to a running replay without restarting it
+                        const double speeds[] = { 1.0, 2.0, 5.0, 10.0, 0.0 };
+                        const char* speedLabels[] = { "1x", "2x", "5x", "10x", "Max" };
+                        int selectedSpeed = -1;
+                        for (int i = 0; i < IM_ARRAYSIZE(speeds); i++) {
+                            if (config.replaySpeed == speeds[i]) {
+                                selectedSpeed = i;
+                                break;
+                            }
+                        }
+                        if (ImGui::Combo("Speed", &selectedSpeed, speedLabels, IM_ARRAYSIZE(speedLabels))) {
+                            if (selectedSpeed >= 0) {
+                                config.replaySpeed = speeds[selectedSpeed];
+                                if (replay) replay->setSpeed(config.replaySpeed);
+                            }
+                        }
+
+                        if (ImGui::Checkbox("Loop", &config.replayLoop)) {
+                            if (config.enabled) _serviceManager.updateServiceState(config);
+                        }
+
+                        if (replay) {
+                            float length = static_cast<float>((replay->getEndTime() - replay->getStartTime()) / 1e9);
+                            float position = static_cast<float>((replay->getPosition() - replay->getStartTime()) / 1e9);
+                            if (ImGui::SliderFloat("Position", &position, 0.0f, length, "%.0f s")) {
+                                replay->seek(replay->getStartTime() + static_cast<int64_t>(position * 1e9));
+                            }
+                            if (!replay->isRunning()) ImGui::Text("Finished");
+                        }
                     }
                     
                     ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "ID: %s", config.id.c_str());
@@ -188,7 +306,7 @@ void CommunicationSettingsWindow::render() {
                         _serviceManager.updateOutputState(config);
                     }
 
-                    const char* types[] = { "Serial", "UDP" };
+                    const char* types[] = { "Serial", "UDP", "TCP Server" };
                     int currentType = (int)config.type;
                     if (ImGui::Combo("Type", &currentType, types, IM_ARRAYSIZE(types))) {
                         config.type = (App::OutputType)currentType;
@@ -228,13 +346,35 @@ void CommunicationSettingsWindow::render() {
                         if (ImGui::InputInt("Target Port", &config.port)) {
                             if (config.enabled) _serviceManager.updateOutputState(config);
                         }
+
+                        if (ImGui::Checkbox("Pack Sentences into Datagrams", &config.coalesce)) {
+                            if (config.enabled) _serviceManager.updateOutputState(config);
+                        }
+                        if (config.coalesce) {
+                            ImGui::Indent();
+                            if (ImGui::InputInt("Max Datagram (bytes)", &config.maxDatagramSize)) {
+                                if (config.enabled) _serviceManager.updateOutputState(config);
+                            }
+                            if (ImGui::InputInt("Flush Delay (ms)", &config.flushDelayMs)) {
+                                if (config.enabled) _serviceManager.updateOutputState(config);
+                            }
+                            ImGui::Unindent();
+                        }
+                    } else if (config.type == App::OutputType::TcpServer) {
+                        if (ImGui::InputInt("Listen Port", &config.port)) {
+                            if (config.enabled) _serviceManager.updateOutputState(config);
+                        }
+                        if (ImGui::InputInt("Max Clients", &config.maxClients)) {
+                            config.maxClients = std::max(config.maxClients, 1);
+                            if (config.enabled) _serviceManager.updateOutputState(config);
+                        }
                     }
 
                     ImGui::Separator();
                     ImGui::Text("Multiplexing");
                     
                     if (ImGui::Checkbox("Multiplex All Sources", &config.multiplexAll)) {
-                        // No immediate action needed, logic is in broadcast
+                        _serviceManager.rebuildRoutes();
                     }
 
                     if (!config.multiplexAll) {
@@ -257,6 +397,7 @@ void CommunicationSettingsWindow::render() {
                                     auto it = std::remove(config.sourceIds.begin(), config.sourceIds.end(), "SIMULATOR");
                                     config.sourceIds.erase(it, config.sourceIds.end());
                                 }
+                                _serviceManager.rebuildRoutes();
                             }
                         }
 
@@ -277,11 +418,69 @@ void CommunicationSettingsWindow::render() {
                                     auto it = std::remove(config.sourceIds.begin(), config.sourceIds.end(), source.id);
                                     config.sourceIds.erase(it, config.sourceIds.end());
                                 }
+                                _serviceManager.rebuildRoutes();
                             }
                         }
                         ImGui::Unindent();
                     }
-                    
+
+                    ImGui::Separator();
+                    ImGui::Text("Filters");
+
+                    char allowBuf[256];
+                    strncpy(allowBuf, joinPatterns(config.allowSentences).c_str(), sizeof(allowBuf) - 1);
+                    allowBuf[sizeof(allowBuf) - 1] = '\0';
+                    if (ImGui::InputText("Allow (empty: all)", allowBuf, sizeof(allowBuf))) {
+                        config.allowSentences = splitPatterns(allowBuf);
+                        _serviceManager.rebuildRoutes();
+                    }
+
+                    char denyBuf[256];
+                    strncpy(denyBuf, joinPatterns(config.denySentences).c_str(), sizeof(denyBuf) - 1);
+                    denyBuf[sizeof(denyBuf) - 1] = '\0';
+                    if (ImGui::InputText("Deny", denyBuf, sizeof(denyBuf))) {
+                        config.denySentences = splitPatterns(denyBuf);
+                        _serviceManager.rebuildRoutes();
+                    }
+                    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "e.g. GPRMC, *GSV (any talker), GP* (any sentence)");
+
+                    for (size_t i = 0; i < config.rateLimits.size(); ++i) {
+                        auto& limit = config.rateLimits[i];
+                        ImGui::PushID(static_cast<int>(i));
+
+                        char sentenceBuf[16];
+                        strncpy(sentenceBuf, limit.sentence.c_str(), sizeof(sentenceBuf) - 1);
+                        sentenceBuf[sizeof(sentenceBuf) - 1] = '\0';
+                        ImGui::SetNextItemWidth(100);
+                        if (ImGui::InputText("##sentence", sentenceBuf, sizeof(sentenceBuf))) {
+                            limit.sentence = sentenceBuf;
+                            _serviceManager.rebuildRoutes();
+                        }
+                        ImGui::SameLine();
+                        ImGui::SetNextItemWidth(120);
+                        if (ImGui::InputInt("ms max rate", &limit.intervalMs)) {
+                            _serviceManager.rebuildRoutes();
+                        }
+                        ImGui::SameLine();
+                        bool removed = ImGui::Button("Remove");
+
+                        ImGui::PopID();
+                        if (removed) {
+                            config.rateLimits.erase(config.rateLimits.begin() + i);
+                            _serviceManager.rebuildRoutes();
+                            break;
+                        }
+                    }
+                    if (ImGui::Button("Add Rate Limit")) {
+                        config.rateLimits.push_back(App::SentenceRateLimit{"*RMC", 1000});
+                        _serviceManager.rebuildRoutes();
+                    }
+
+                    if (ImGui::InputDouble("AIS Range (NM, 0: all)", &config.aisRangeNm, 1.0, 10.0, "%.1f")) {
+                        config.aisRangeNm = std::max(config.aisRangeNm, 0.0);
+                        _serviceManager.rebuildRoutes();
+                    }
+
                     ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "ID: %s", config.id.c_str());
                 } else {
                     ImGui::Text("Select an output to edit");
@@ -290,6 +489,43 @@ void CommunicationSettingsWindow::render() {
                 ImGui::Columns(1);
                 ImGui::EndTabItem();
             }
+
+            // --- RECORDING TAB ---
+            if (ImGui::BeginTabItem("Recording")) {
+                App::RecordingConfig& config = _serviceManager.getRecordingConfig();
+
+                ImGui::TextWrapped("Records every sentence received, from all sources, with its time and source.");
+                ImGui::Separator();
+
+                if (ImGui::Checkbox("Enabled", &config.enabled)) {
+                    _serviceManager.updateRecordingState();
+                }
+
+                char directoryBuf[256];
+                strncpy(directoryBuf, config.directory.c_str(), sizeof(directoryBuf) - 1);
+                directoryBuf[sizeof(directoryBuf) - 1] = '\0';
+                if (ImGui::InputText("Directory", directoryBuf, sizeof(directoryBuf))) {
+                    config.directory = directoryBuf;
+                }
+                if (ImGui::InputInt("Segment Size (MB)", &config.segmentSizeMB)) {
+                    config.segmentSizeMB = std::max(config.segmentSizeMB, 1);
+                }
+                if (ImGui::InputInt("Segment Duration (min)", &config.segmentMinutes)) {
+                    config.segmentMinutes = std::max(config.segmentMinutes, 1);
+                }
+                if (config.enabled && ImGui::Button("Apply")) {
+                    _serviceManager.updateRecordingState(); // Starts a new segment
+                }
+
+                if (auto stats = _serviceManager.getRecorderStats()) {
+                    ImGui::Separator();
+                    ImGui::Text("%llu sentences, %.1f MB in %llu segments, %llu dropped",
+                                (unsigned long long)stats->records, stats->bytes / (1024.0 * 1024.0),
+                                (unsigned long long)stats->segments, (unsigned long long)stats->dropped);
+                }
+
+                ImGui::EndTabItem();
+            }
             
             ImGui::EndTabBar();
         }
@@ -1,5 +1,9 @@
 #include "DashboardWindow.hpp"
 #include "app/services/ServiceManager.hpp"
+#include "parsers/NmeaParser.hpp"
+#include "core/AisTargetStore.hpp"
+#include "network/IoRuntime.hpp"
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <ctime>
@@ -8,7 +12,7 @@ namespace Gui {
 
 DashboardWindow::DashboardWindow() {}
 
-void DashboardWindow::updateData(const Core::NavData& update) {
+void DashboardWindow::updateData(const Core::CompactNavData& update) {
     std::lock_guard<std::mutex> lock(_dataMutex);
     
     // Merge logic
@@ -18,11 +22,11 @@ void DashboardWindow::updateData(const Core::NavData& update) {
     if (update.windSpeed != 0.0) _lastData.windSpeed = update.windSpeed;
     if (update.windAngle != 0.0) _lastData.windAngle = update.windAngle;
     
-    _lastData.timestamp = update.timestamp;
-    _lastData.sourceId = update.sourceId;
+    _lastData.timestampNs = update.timestampNs;
+    _lastData.source = update.source;
     
     _packetCount++;
-    _lastSource = update.sourceId;
+    _hasData = true;
 }
 
 void DashboardWindow::render(Core::ThreadPool& threadPool, const App::ServiceManager& serviceManager) {
@@ -30,19 +34,18 @@ void DashboardWindow::render(Core::ThreadPool& threadPool, const App::ServiceMan
     auto lock = serviceManager.getLock();
     
     size_t poolThreads = threadPool.getBusyCount();
-    size_t serviceThreads = serviceManager.getActiveServices().size();
-    size_t outputThreads = serviceManager.getActiveOutputs().size();
-    size_t totalThreads = poolThreads + serviceThreads + outputThreads;
+    size_t ioThreads = Network::IoRuntime::instance().getThreadCount();
+    size_t totalThreads = poolThreads + ioThreads;
 
     ImGui::Text("System Status: Running");
-    ImGui::Text("Active Threads: %zu (Pool: %zu, IO: %zu)", totalThreads, poolThreads, serviceThreads + outputThreads);
+    ImGui::Text("Active Threads: %zu (Pool: %zu, IO: %zu)", totalThreads, poolThreads, ioThreads);
     ImGui::Separator();
 
     {
         std::lock_guard<std::mutex> lock(_dataMutex);
         
         ImGui::TextColored(ImVec4(0,1,0,1), "Live Data");
-        ImGui::Text("Source: %s", _lastSource.c_str());
+        ImGui::Text("Source: %s", _hasData ? Core::SourceRegistry::instance().name(_lastData.source).c_str() : "None");
         ImGui::Text("Packets Received: %llu", _packetCount);
         
         ImGui::Separator();
@@ -51,7 +54,7 @@ void DashboardWindow::render(Core::ThreadPool& threadPool, const App::ServiceMan
         ImGui::Text("Wind:    %.1f kts @ %.1f deg", _lastData.windSpeed, _lastData.windAngle);
         
         // Time display
-        auto time = std::chrono::system_clock::to_time_t(_lastData.timestamp);
+        auto time = std::chrono::system_clock::to_time_t(_lastData.timestamp());
         std::tm* tm = std::localtime(&time);
         char timeBuffer[32];
         std::strftime(timeBuffer, sizeof(timeBuffer), "%H:%M:%S", tm);
@@ -67,10 +70,11 @@ void DashboardWindow::render(Core::ThreadPool& threadPool, const App::ServiceMan
     if (sources.empty()) {
         ImGui::TextDisabled("No services configured");
     } else {
-        if (ImGui::BeginTable("ServicesTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        if (ImGui::BeginTable("ServicesTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
             ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
             ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed, 60.0f);
             ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+            ImGui::TableSetupColumn("Framing", ImGuiTableColumnFlags_WidthFixed, 80.0f);
             ImGui::TableHeadersRow();
 
             for (const auto& source : sources) {
@@ -83,6 +87,8 @@ void DashboardWindow::render(Core::ThreadPool& threadPool, const App::ServiceMan
                 if (source.type == App::SourceType::Serial) typeStr = "Serial";
                 else if (source.type == App::SourceType::Udp) typeStr = "UDP";
                 else if (source.type == App::SourceType::Simulator) typeStr = "Sim";
+                else if (source.type == App::SourceType::TcpClient) typeStr = "TCP";
+                else if (source.type == App::SourceType::Replay) typeStr = "Replay";
                 ImGui::TextUnformatted(typeStr);
 
                 ImGui::TableSetColumnIndex(2);
@@ -96,16 +102,115 @@ void DashboardWindow::render(Core::ThreadPool& threadPool, const App::ServiceMan
                         ImGui::TextColored(ImVec4(1, 0, 0, 1), "Null Ptr");
                     } else if (!it->second->isRunning()) {
                         ImGui::TextColored(ImVec4(1, 0, 0, 1), "Stopped");
+                    } else if (!it->second->isConnected()) {
+                        ImGui::TextColored(ImVec4(1, 1, 0, 1), "Connecting");
                     } else {
                         ImGui::TextColored(ImVec4(0, 1, 0, 1), "Running");
                     }
                 }
+
+                // Overflowed lines / resyncs of the stream framer
+                ImGui::TableSetColumnIndex(3);
+                if (auto framing = serviceManager.getFramerStats(source.id)) {
+                    ImGui::Text("%llu / %llu", (unsigned long long)framing->overflows, (unsigned long long)framing->resyncs);
+                } else {
+                    ImGui::TextDisabled("-");
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("NMEA Sentences")) {
+        auto stats = Parsers::NmeaParser::getSentenceStats();
+        std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) { return a.hits > b.hits; });
+
+        if (ImGui::BeginTable("SentenceTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+            ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Received", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+            ImGui::TableSetupColumn("Errors", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableHeadersRow();
+
+            for (const auto& entry : stats) {
+                if (entry.hits == 0) continue;
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(entry.formatter.c_str());
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%llu", (unsigned long long)entry.hits);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%llu", (unsigned long long)entry.failures);
             }
             ImGui::EndTable();
         }
+        ImGui::Text("Unhandled: %llu", (unsigned long long)Parsers::NmeaParser::getUnhandledCount());
+    }
+
+    if (ImGui::CollapsingHeader("Outputs")) {
+        auto now = std::chrono::steady_clock::now();
+        std::map<std::string, OutputRate> peerRates;
+        for (const auto& output : serviceManager.getOutputs()) {
+            auto stats = serviceManager.getOutputStats(output.id);
+            if (!stats) {
+                _outputRates.erase(output.id);
+                continue;
+            }
+
+            const OutputRate& rate = sampleRate(_outputRates, output.id, *stats, now);
+            ImGui::Text("%s: %.0f sentences/s, %.0f packets/s, %.1f kB/s, %llu dropped", output.name.c_str(),
+                        rate.messagesPerSecond, rate.packetsPerSecond, rate.bytesPerSecond / 1000.0,
+                        (unsigned long long)stats->dropped);
+            if (output.type == App::OutputType::Serial) {
+                ImGui::Text("    %llu queued, %llu superseded by newer data",
+                            (unsigned long long)stats->queued, (unsigned long long)stats->superseded);
+            }
+
+            // Server outputs: one line per client
+            for (const auto& peer : serviceManager.getOutputPeers(output.id)) {
+                std::string key = output.id + "/" + peer.address;
+                if (auto previous = _peerRates.extract(key)) peerRates.insert(std::move(previous));
+                const OutputRate& peerRate = sampleRate(peerRates, key, peer.traffic, now);
+                auto connected = std::chrono::duration_cast<std::chrono::seconds>(now - peer.connectedAt).count();
+                ImGui::Text("    %s: %.0f sentences/s, %.1f kB/s, %llu queued, %llu dropped, %llds",
+                            peer.address.c_str(), peerRate.messagesPerSecond, peerRate.bytesPerSecond / 1000.0,
+                            (unsigned long long)peer.traffic.queued, (unsigned long long)peer.traffic.dropped,
+                            (long long)connected);
+            }
+        }
+        _peerRates = std::move(peerRates); // Forget disconnected clients
+    }
+
+    if (ImGui::CollapsingHeader("AIS")) {
+        ImGui::Text("Targets: %zu", Core::AisTargetStore::instance().size());
+        for (const auto& source : sources) {
+            if (auto ais = serviceManager.getAisStats(source.id)) {
+                ImGui::Text("%s: %llu decoded, %llu errors, %llu fragments lost", source.name.c_str(),
+                            (unsigned long long)ais->decoded, (unsigned long long)ais->errors,
+                            (unsigned long long)ais->droppedFragments);
+            }
+        }
     }
 
     ImGui::End();
 }
 
+// Rates over the last second or so, from monotonic counters
+const DashboardWindow::OutputRate& DashboardWindow::sampleRate(std::map<std::string, OutputRate>& rates, const std::string& key,
+                                                               const Network::TrafficStats& stats,
+                                                               std::chrono::steady_clock::time_point now) {
+    auto [it, inserted] = rates.try_emplace(key);
+    OutputRate& rate = it->second;
+    double elapsed = std::chrono::duration<double>(now - rate.sampledAt).count();
+    if (inserted || stats.packets < rate.sample.packets) {
+        rate = OutputRate{now, stats};
+    } else if (elapsed >= 1.0) {
+        rate.messagesPerSecond = (stats.messages - rate.sample.messages) / elapsed;
+        rate.packetsPerSecond = (stats.packets - rate.sample.packets) / elapsed;
+        rate.bytesPerSecond = (stats.bytes - rate.sample.bytes) / elapsed;
+        rate.sampledAt = now;
+        rate.sample = stats;
+    }
+    return rate;
+}
+
 } // namespace Gui
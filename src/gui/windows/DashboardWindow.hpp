@@ -1,8 +1,11 @@
 #pragma once
 
-#include "core/NavData.hpp"
+#include "core/CompactNavData.hpp"
 #include "core/ThreadPool.hpp"
+#include "network/IService.hpp"
 #include "imgui.h"
+#include <chrono>
+#include <map>
 #include <mutex>
 #include <string>
 
@@ -15,13 +18,27 @@ public:
     DashboardWindow();
 
     void render(Core::ThreadPool& threadPool, const App::ServiceManager& serviceManager);
-    void updateData(const Core::NavData& data);
+    void updateData(const Core::CompactNavData& data);
 
 private:
     std::mutex _dataMutex;
-    Core::NavData _lastData;
-    std::string _lastSource = "None";
+    Core::CompactNavData _lastData;
+    bool _hasData = false;
     uint64_t _packetCount = 0;
+
+    // Output throughput, sampled about once per second (render thread only)
+    struct OutputRate {
+        std::chrono::steady_clock::time_point sampledAt;
+        Network::TrafficStats sample;
+        double messagesPerSecond = 0.0;
+        double packetsPerSecond = 0.0;
+        double bytesPerSecond = 0.0;
+    };
+    std::map<std::string, OutputRate> _outputRates;
+    std::map<std::string, OutputRate> _peerRates; // By "<output id>/<client address>"
+
+    static const OutputRate& sampleRate(std::map<std::string, OutputRate>& rates, const std::string& key,
+                                        const Network::TrafficStats& stats, std::chrono::steady_clock::time_point now);
 };
 
 } // namespace Gui
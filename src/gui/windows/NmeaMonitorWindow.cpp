@@ -4,15 +4,17 @@ namespace Gui {
 
 NmeaMonitorWindow::NmeaMonitorWindow() {}
 
-void NmeaMonitorWindow::addLog(const std::string& source, const std::string& frame) {
+void NmeaMonitorWindow::addLog(const std::string& source, std::string_view frame) {
     if (!_visible) return;
     
     std::lock_guard<std::mutex> lock(_logMutex);
     
     if (_paused) return; // Don't add logs if paused
 
-    std::string logEntry = "[" + source + "] " + frame + "\n";
-    _logs.push_back(logEntry);
+    std::string logEntry;
+    logEntry.reserve(source.size() + frame.size() + 4);
+    logEntry.append("[").append(source).append("] ").append(frame).append("\n");
+    _logs.push_back(std::move(logEntry));
     if (_logs.size() > _maxLogs) {
         _logs.pop_front();
     }
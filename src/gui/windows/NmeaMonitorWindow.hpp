@@ -2,6 +2,7 @@
 
 #include "imgui.h"
 #include <string>
+#include <string_view>
 #include <deque>
 #include <mutex>
 
@@ -12,7 +13,7 @@ public:
     NmeaMonitorWindow();
     
     void render();
-    void addLog(const std::string& source, const std::string& frame);
+    void addLog(const std::string& source, std::string_view frame);
     
     void show() { _visible = true; }
     void hide() { _visible = false; }
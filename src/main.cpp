@@ -1,37 +1,72 @@
 #include "app/NavOneApp.hpp"
+#include "app/services/BatchProcessor.hpp"
 #include "core/ThreadPool.hpp"
+#include "network/IoRuntime.hpp"
+#include <algorithm>
 #include <iostream>
 #include <csignal>
 #include <string>
+#include <thread>
 
-// Global pointer for signal handler
-App::NavOneApp* g_app = nullptr;
+// Only async-signal-safe work here: the app picks the request up from a timer task
+void signalHandler(int) {
+    App::NavOneApp::requestStop();
+}
 
-void signalHandler(int signum) {
-    std::cout << "\nInterrupt signal (" << signum << ") received.\n";
-    if (g_app) {
-        g_app->stop();
-    }
+// -batch: process log files offline and exit, without I/O or GUI
+int runBatch(App::BatchProcessor::Options options, size_t threads) {
+    Core::ThreadPool pool(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()));
+    App::BatchProcessor processor(pool, std::move(options));
+    App::BatchProcessor::Summary summary = processor.run();
+
+    double megabytes = summary.bytes / (1024.0 * 1024.0);
+    double seconds = std::max(summary.seconds, 1e-6);
+    std::cout << "Processed " << summary.sentences << " sentences (" << megabytes << " MB) from "
+              << summary.files << " files in " << summary.chunks << " chunks, " << summary.seconds << " s: "
+              << megabytes / seconds << " MB/s, " << summary.sentences / seconds << " sentences/s\n"
+              << "Parsed " << summary.parsed << ", checksum errors " << summary.checksumErrors
+              << ", track points " << summary.trackPoints << std::endl;
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
     try {
         bool headless = false;
+        size_t ioThreads = Network::IoRuntime::DefaultThreads;
+        bool batch = false;
+        App::BatchProcessor::Options batchOptions;
+        size_t batchThreads = 0;
         
         // Parse arguments
         for (int i = 1; i < argc; ++i) {
             std::string arg = argv[i];
             if (arg == "-nogui") {
                 headless = true;
+            } else if (arg == "-iothreads" && i + 1 < argc) {
+                ioThreads = std::stoul(argv[++i]);
+            } else if (arg == "-batch" && i + 1 < argc) {
+                // -batch <output dir> [-interval ms] [-threads n] <log files or directories...>
+                batch = true;
+                batchOptions.outputDirectory = argv[++i];
+            } else if (arg == "-interval" && i + 1 < argc) {
+                batchOptions.intervalMs = std::stoll(argv[++i]);
+            } else if (arg == "-threads" && i + 1 < argc) {
+                batchThreads = std::stoul(argv[++i]);
+            } else if (!arg.empty() && arg[0] != '-') {
+                batchOptions.inputs.push_back(arg);
             }
         }
 
+        if (batch) {
+            return runBatch(std::move(batchOptions), batchThreads);
+        }
+
         // 1. Initialize Core Services
         Core::ThreadPool pool(4); // 4 worker threads
+        Network::IoRuntime::instance().start(ioThreads); // Shared by every serial/UDP service
 
         // 2. Initialize App
         App::NavOneApp app(pool, headless);
-        g_app = &app;
         
         // Register signal handler for Ctrl+C
         signal(SIGINT, signalHandler);
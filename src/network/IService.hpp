@@ -1,15 +1,40 @@
 #pragma once
+#include "core/SentenceRef.hpp"
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace Network {
 
+// Counters of an output, monotonic since start()
+struct TrafficStats {
+    uint64_t messages = 0; // Sentences handed to send()
+    uint64_t packets = 0;  // Datagrams / writes on the wire
+    uint64_t bytes = 0;
+    uint64_t dropped = 0;  // Sentences lost (send buffer full, errors)
+    uint64_t superseded = 0; // Replaced while queued by a newer sentence of the same type (paced outputs)
+    uint64_t queued = 0;     // Sentences waiting, current value (paced outputs)
+};
+
+// Counters of one connected client of a server output
+struct PeerStats {
+    std::string address; // "ip:port"
+    std::chrono::steady_clock::time_point connectedAt;
+    TrafficStats traffic;
+};
+
 class IService {
 public:
     virtual ~IService() = default;
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual bool isRunning() const = 0;
-    virtual void send(const std::string& data) {}
+    // Connection-oriented services: started, and the link is up
+    virtual bool isConnected() const { return isRunning(); }
+    virtual void send(const Core::SentenceRef& sentence) {}
+    virtual TrafficStats getTrafficStats() const { return {}; }
+    virtual std::vector<PeerStats> getPeerStats() const { return {}; }
 };
 
 } // namespace Network
@@ -0,0 +1,62 @@
+#include "IoRuntime.hpp"
+#include <iostream>
+
+namespace Network {
+
+IoRuntime::IoRuntime() : _workGuard(asio::make_work_guard(_context)) {
+}
+
+IoRuntime::~IoRuntime() {
+    _workGuard.reset();
+    _context.stop();
+    for (auto& thread : _threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void IoRuntime::start(size_t threads) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_threads.empty()) return;
+    if (threads == 0) threads = 1;
+
+    for (size_t i = 0; i < threads; ++i) {
+        _threads.emplace_back([this] {
+            for (;;) {
+                try {
+                    _context.run();
+                    return;
+                } catch (const std::exception& e) {
+                    // A throwing handler must not take the whole runtime down
+                    std::cerr << "I/O Runtime Error: " << e.what() << std::endl;
+                }
+            }
+        });
+    }
+}
+
+asio::io_context& IoRuntime::context() {
+    start();
+    return _context;
+}
+
+size_t IoRuntime::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _threads.size();
+}
+
+void PendingOps::begin() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _count++;
+}
+
+void PendingOps::end() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (--_count == 0) _idle.notify_all();
+}
+
+void PendingOps::waitIdle() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _count == 0; });
+}
+
+} // namespace Network
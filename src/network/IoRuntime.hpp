@@ -0,0 +1,80 @@
+#pragma once
+
+#include <asio.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Network {
+
+// Event loop shared by every network service: a single io_context run by a small
+// number of threads, instead of one io_context and one mostly idle thread per service.
+//
+// Handlers of different services may run concurrently: each service serializes its own
+// handlers with a strand.
+class IoRuntime {
+public:
+    using Strand = asio::strand<asio::io_context::executor_type>;
+
+    static IoRuntime& instance() {
+        static IoRuntime instance;
+        return instance;
+    }
+
+    // Start the threads. Only the first call has an effect: services start the runtime
+    // with the default thread count if the application didn't.
+    void start(size_t threads = DefaultThreads);
+
+    asio::io_context& context();
+    Strand makeStrand() { return asio::make_strand(context()); }
+
+    size_t getThreadCount() const;
+
+    static constexpr size_t DefaultThreads = 2;
+
+private:
+    IoRuntime();
+    ~IoRuntime();
+    IoRuntime(const IoRuntime&) = delete;
+    IoRuntime& operator=(const IoRuntime&) = delete;
+
+    asio::io_context _context;
+    asio::executor_work_guard<asio::io_context::executor_type> _workGuard;
+    std::vector<std::thread> _threads;
+    mutable std::mutex _mutex;
+};
+
+// Asynchronous operations of a service still referring to it. Without a thread of its own
+// to join, a service stops by closing its handles and waiting for this count to drop to zero.
+class PendingOps {
+public:
+    // Wraps a completion handler: counted from now until the handler has returned
+    template<class Handler>
+    auto wrap(Handler&& handler) {
+        begin();
+        return [this, handler = std::forward<Handler>(handler)](auto&&... args) mutable {
+            Done done{this};
+            handler(std::forward<decltype(args)>(args)...);
+        };
+    }
+
+    void waitIdle();
+
+private:
+    struct Done {
+        PendingOps* ops;
+        ~Done() { ops->end(); }
+    };
+
+    void begin();
+    void end();
+
+    std::mutex _mutex;
+    std::condition_variable _idle;
+    size_t _count = 0;
+};
+
+} // namespace Network
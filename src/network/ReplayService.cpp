@@ -0,0 +1,117 @@
+#include "ReplayService.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace Network {
+
+ReplayService::ReplayService(const std::string& path, double speed, bool loop, SentenceCallback callback)
+    : _log(std::make_unique<Utils::ReplayLog>(path)), _loop(loop), _onSentence(std::move(callback)),
+      _speed(std::max(speed, 0.0)) {
+    _position = _log->getStartTime();
+}
+
+ReplayService::~ReplayService() {
+    stop();
+}
+
+void ReplayService::start() {
+    if (_playing) return;
+    if (_thread.joinable()) _thread.join(); // Finished playing: restart from the beginning
+    _stop = false;
+    _playing = true;
+    _thread = std::thread([this] { run(); });
+}
+
+void ReplayService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    if (_thread.joinable()) _thread.join();
+    _playing = false;
+}
+
+void ReplayService::setSpeed(double speed) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _speed = std::max(speed, 0.0);
+    }
+    _wake.notify_all();
+}
+
+void ReplayService::seek(int64_t timeNs) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _seekTo = std::clamp(timeNs, _log->getStartTime(), _log->getEndTime());
+    }
+    _wake.notify_all();
+}
+
+void ReplayService::run() {
+    Utils::ReplayLog::Cursor cursor(*_log);
+    Utils::ReplayLog::Entry entry;
+
+    // Sentence at log time t is due at wallAnchor + (t - logAnchor) / speed.
+    // Re-anchored on the next sentence after a seek or a speed change.
+    bool anchored = false;
+    int64_t logAnchor = 0;
+    Clock::time_point wallAnchor;
+    double anchorSpeed = 0.0;
+
+    bool pending = false; // 'entry' read, not played yet
+    while (!_stop) {
+        int64_t seekTo = _seekTo.exchange(NoSeek);
+        if (seekTo != NoSeek) {
+            cursor.seek(seekTo);
+            pending = false;
+            anchored = false;
+            _position = seekTo;
+        }
+
+        if (!pending) {
+            if (!cursor.next(entry)) {
+                if (!_loop) break;
+                cursor.seek(_log->getStartTime());
+                anchored = false;
+                if (!cursor.next(entry)) break;
+            }
+            pending = true;
+        }
+
+        double speed = _speed;
+        if (speed > 0.0) {
+            Clock::time_point now = Clock::now();
+            if (!anchored || speed != anchorSpeed) {
+                logAnchor = entry.timeNs;
+                wallAnchor = now;
+                anchorSpeed = speed;
+                anchored = true;
+            }
+
+            auto offset = std::chrono::nanoseconds(static_cast<int64_t>((entry.timeNs - logAnchor) / speed));
+            Clock::time_point due = wallAnchor + std::chrono::duration_cast<Clock::duration>(offset);
+            if (due > now) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait_until(lock, due, [this, speed] {
+                    return _stop || _seekTo != NoSeek || _speed != speed;
+                });
+                continue; // Due now, or controls changed
+            }
+        } else {
+            anchored = false;
+        }
+
+        try {
+            _onSentence(entry.sentence);
+        } catch (const std::exception& e) {
+            std::cerr << "Replay callback failed: " << e.what() << std::endl;
+        }
+        _position = entry.timeNs;
+        pending = false;
+    }
+
+    _playing = false;
+}
+
+} // namespace Network
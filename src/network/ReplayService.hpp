@@ -0,0 +1,66 @@
+#pragma once
+
+#include "IService.hpp"
+#include "utils/ReplayLog.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Network {
+
+// Replay source: plays a recording or NMEA text log (Utils::ReplayLog) back as live input.
+//
+// Sentences keep their recorded spacing divided by the speed factor; speed 0 replays as fast
+// as the callback takes them. Speed changes and seeks apply to the next sentence, without
+// restarting. Runs on its own thread, the callback is called from it.
+class ReplayService : public IService {
+public:
+    // 'sentence' points into the mapped log, valid during the call only
+    using SentenceCallback = std::function<void(std::string_view sentence)>;
+
+    // Throws std::runtime_error if the log can't be opened
+    ReplayService(const std::string& path, double speed, bool loop, SentenceCallback callback);
+    ~ReplayService();
+
+    void start() override;
+    void stop() override;
+    // False once the end is reached (unless looping)
+    bool isRunning() const override { return _playing; }
+
+    void setSpeed(double speed); // 1: real time, 0: as fast as possible
+    double getSpeed() const { return _speed; }
+    void seek(int64_t timeNs);   // Log time, between getStartTime() and getEndTime()
+
+    int64_t getStartTime() const { return _log->getStartTime(); }
+    int64_t getEndTime() const { return _log->getEndTime(); }
+    int64_t getPosition() const { return _position; } // Log time of the last sentence played
+    bool hasWallClock() const { return _log->hasWallClock(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int64_t NoSeek = INT64_MIN;
+
+    void run();
+
+    std::unique_ptr<Utils::ReplayLog> _log;
+    bool _loop;
+    SentenceCallback _onSentence;
+
+    std::thread _thread;
+    std::mutex _mutex; // Wakes the thread early
+    std::condition_variable _wake;
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _playing{false};
+    std::atomic<double> _speed;
+    std::atomic<int64_t> _seekTo{NoSeek};
+    std::atomic<int64_t> _position{0};
+};
+
+} // namespace Network
@@ -0,0 +1,174 @@
+#include "SerialOutputQueue.hpp"
+#include "parsers/NmeaFields.hpp"
+#include <algorithm>
+
+namespace Network {
+
+namespace {
+
+// Address field ("GPHDT") packed into an integer key
+uint64_t keyOf(std::string_view sentence) {
+    uint64_t key = 0;
+    for (size_t i = 1; i < sentence.size() && i <= 8; ++i) {
+        if (sentence[i] == ',' || sentence[i] == '*') break;
+        key = (key << 8) | static_cast<uint8_t>(sentence[i]);
+    }
+    return key;
+}
+
+bool isOneOf(std::string_view formatter, std::initializer_list<std::string_view> formatters) {
+    return std::find(formatters.begin(), formatters.end(), formatter) != formatters.end();
+}
+
+size_t aisIndex(SerialOutputQueue::Priority priority) {
+    return priority == SerialOutputQueue::Priority::AisStatic ? 1 : 0;
+}
+
+} // namespace
+
+SerialOutputQueue::SerialOutputQueue(size_t aisBudget) : _aisBudget(aisBudget) {}
+
+SerialOutputQueue::Priority SerialOutputQueue::classify(std::string_view sentence, bool& continuation) {
+    continuation = false;
+
+    if (sentence[0] == '!') {
+        // !AIVDM,count,number,sequence,channel,payload,fill*hh
+        Parsers::NmeaFields fields;
+        fields.tokenize(sentence.substr(1, sentence.find('*') - 1));
+        int number = 1;
+        Parsers::toInt(fields[2], number);
+        if (number > 1) {
+            continuation = true;
+            return _lastAisPriority;
+        }
+
+        // Message type: first 6-bit character of the payload
+        int type = 0;
+        if (!fields[5].empty()) {
+            type = fields[5][0] - 48;
+            if (type > 40) type -= 8;
+        }
+        _lastAisPriority = (type == 5 || type == 24) ? Priority::AisStatic : Priority::AisDynamic;
+        return _lastAisPriority;
+    }
+
+    std::string_view address = sentence.substr(1, sentence.find_first_of(",*") - 1);
+    if (address.size() != 5) return Priority::Other; // Proprietary
+    std::string_view formatter = address.substr(2);
+
+    if (isOneOf(formatter, {"HDG", "HDM", "HDT", "THS", "ROT", "RSA", "APB", "XTE", "RMB"})) {
+        return Priority::Steering;
+    }
+    if (isOneOf(formatter, {"RMC", "GGA", "GLL", "GNS", "VTG", "VHW", "ZDA"})) {
+        return Priority::Navigation;
+    }
+    return Priority::Other;
+}
+
+void SerialOutputQueue::push(Core::SentenceRef sentence) {
+    std::string_view text = sentence.sentence();
+    if (text.empty()) return;
+
+    bool continuation = false;
+    Priority priority = classify(text, continuation);
+    if (priority == Priority::AisDynamic || priority == Priority::AisStatic) {
+        pushAis(std::move(sentence), priority, continuation);
+        return;
+    }
+
+    // Freshest wins: replace in place, keeping the queue position
+    uint64_t key = keyOf(text);
+    auto& queue = _keyed[static_cast<size_t>(priority)];
+    for (auto& entry : queue) {
+        if (entry.key == key) {
+            entry.sentence = std::move(sentence);
+            _superseded++;
+            return;
+        }
+    }
+
+    if (_keyCount >= MaxKeys) {
+        _dropped++;
+        return;
+    }
+    queue.push_back(Keyed{key, std::move(sentence)});
+    _keyCount++;
+    _size++;
+}
+
+void SerialOutputQueue::pushAis(Core::SentenceRef sentence, Priority priority, bool continuation) {
+    if (!continuation) {
+        _aisMessage++;
+        _aisMessageKept = true;
+    }
+
+    // A fragment whose message was dropped is useless
+    size_t length = sentence.line().size();
+    if (!_aisMessageKept || length > _aisBudget) {
+        _aisMessageKept = false;
+        _dropped++;
+        return;
+    }
+
+    while (_aisBytes + length > _aisBudget) {
+        dropOldestAisMessage();
+    }
+    if (!_aisMessageKept) { // Its own first fragments were the oldest
+        _dropped++;
+        return;
+    }
+
+    _ais[aisIndex(priority)].push_back(AisEntry{std::move(sentence), _aisMessage, continuation});
+    _aisBytes += length;
+    _size++;
+}
+
+// Statics first, and whole messages (first fragment and its continuations)
+void SerialOutputQueue::dropOldestAisMessage() {
+    auto& queue = _ais[1].empty() ? _ais[0] : _ais[1];
+    if (queue.empty()) return;
+
+    uint64_t message = queue.front().message;
+    if (message == _aisMessage) _aisMessageKept = false;
+    while (!queue.empty() && queue.front().message == message) {
+        _aisBytes -= queue.front().sentence.line().size();
+        queue.pop_front();
+        _size--;
+        _dropped++;
+    }
+}
+
+Core::SentenceRef SerialOutputQueue::pop() {
+    for (size_t i = 0; i < static_cast<size_t>(Priority::AisDynamic); ++i) {
+        auto& queue = _keyed[i];
+        if (queue.empty()) continue;
+
+        Core::SentenceRef sentence = std::move(queue.front().sentence);
+        queue.pop_front();
+        _keyCount--;
+        _size--;
+        return sentence;
+    }
+
+    for (auto& queue : _ais) {
+        if (queue.empty()) continue;
+
+        Core::SentenceRef sentence = std::move(queue.front().sentence);
+        queue.pop_front();
+        _aisBytes -= sentence.line().size();
+        _size--;
+        return sentence;
+    }
+    return {};
+}
+
+void SerialOutputQueue::clear() {
+    for (auto& queue : _keyed) queue.clear();
+    for (auto& queue : _ais) queue.clear();
+    _aisBytes = 0;
+    _aisMessageKept = false;
+    _keyCount = 0;
+    _size = 0;
+}
+
+} // namespace Network
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/SentenceRef.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+namespace Network {
+
+// Write queue of a slow serial output (4800 baud: about 8 sentences per second).
+//
+// NMEA sentences are keyed by address (talker + formatter) and only the newest one of each
+// key is kept: a newer heading replaces the queued one in place, so it never waits behind
+// older headings. Queued sentences are sent by priority (steering data first, AIS statics
+// last). AIS sentences can't be merged that way: they are kept in order, as whole messages,
+// within a byte budget, the oldest being dropped first.
+//
+// Not thread-safe: used from the strand of its SerialService.
+class SerialOutputQueue {
+public:
+    enum class Priority { Steering, Navigation, Other, AisDynamic, AisStatic };
+    static constexpr size_t PriorityCount = 5;
+
+    static constexpr size_t MaxKeys = 64; // Distinct sentence keys waiting at once
+
+    // 'aisBudget': most AIS bytes waiting at once
+    explicit SerialOutputQueue(size_t aisBudget);
+
+    void push(Core::SentenceRef sentence);
+
+    // Next sentence to write, empty if none
+    Core::SentenceRef pop();
+
+    void clear();
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    uint64_t getSuperseded() const { return _superseded; } // Replaced by a newer sentence of the same key
+    uint64_t getDropped() const { return _dropped; }       // Over MaxKeys or the AIS budget
+
+private:
+    struct Keyed {
+        uint64_t key;
+        Core::SentenceRef sentence;
+    };
+
+    struct AisEntry {
+        Core::SentenceRef sentence;
+        uint64_t message;  // Sequence number of the message in this queue
+        bool continuation; // Second and next fragments of a multipart message
+    };
+
+    Priority classify(std::string_view sentence, bool& continuation);
+    void pushAis(Core::SentenceRef sentence, Priority priority, bool continuation);
+    void dropOldestAisMessage();
+
+    std::array<std::deque<Keyed>, PriorityCount> _keyed;
+    std::array<std::deque<AisEntry>, 2> _ais; // AisDynamic, AisStatic
+    size_t _aisBudget;
+    size_t _aisBytes = 0;
+    Priority _lastAisPriority = Priority::AisDynamic; // Of the last first fragment
+    uint64_t _aisMessage = 0;      // Message of the last first fragment
+    bool _aisMessageKept = false;  // Its fragments so far are queued or sent
+
+    size_t _keyCount = 0;
+    size_t _size = 0;
+    uint64_t _superseded = 0;
+    uint64_t _dropped = 0;
+};
+
+} // namespace Network
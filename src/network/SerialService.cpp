@@ -1,10 +1,15 @@
 #include "SerialService.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace Network {
 
 SerialService::SerialService(const std::string& port, unsigned int baud, DataCallback callback) 
-    : _portName(port), _baudRate(baud), _onDataReceived(callback), _recvBuffer(1024) {
+    : _portName(port), _baudRate(baud), _onDataReceived(callback),
+      _strand(IoRuntime::instance().makeStrand()), _recvBuffer(1024),
+      _bytesPerSecond(std::max(baud, 10u) / 10.0),
+      _writeQueue(std::max<size_t>(static_cast<size_t>(_bytesPerSecond * MaxAisBacklogSeconds),
+                                   Core::SentenceRef::PooledCapacity)) {
 }
 
 SerialService::~SerialService() {
@@ -13,9 +18,10 @@ SerialService::~SerialService() {
 
 void SerialService::start() {
     if (_running) return;
-    
+    stop(); // Release a port left open by a receive error
+
     try {
-        _serialPort = std::make_unique<asio::serial_port>(_ioContext);
+        _serialPort = std::make_unique<asio::serial_port>(_strand);
         _serialPort->open(_portName);
         
         _serialPort->set_option(asio::serial_port_base::baud_rate(_baudRate));
@@ -24,16 +30,16 @@ void SerialService::start() {
         _serialPort->set_option(asio::serial_port_base::stop_bits(asio::serial_port_base::stop_bits::one));
         _serialPort->set_option(asio::serial_port_base::flow_control(asio::serial_port_base::flow_control::none));
 
+        _messages = 0;
+        _packets = 0;
+        _bytes = 0;
+        _dropped = 0;
+        _writeErrors = 0;
+        _queued = 0;
+        _superseded = 0;
+        _linkFreeAt = std::chrono::steady_clock::now();
         _running = true;
-        startReceive();
-
-        _serviceThread = std::thread([this]() {
-            try {
-                _ioContext.run();
-            } catch (const std::exception& e) {
-                std::cerr << "Serial Service Error: " << e.what() << std::endl;
-            }
-        });
+        asio::post(_strand, _ops.wrap([this]() { startReceive(); }));
     } catch (const std::exception& e) {
         std::cerr << "Failed to start Serial Service on " << _portName << ": " << e.what() << std::endl;
         _running = false;
@@ -41,23 +47,26 @@ void SerialService::start() {
 }
 
 void SerialService::stop() {
-    if (!_running) return;
     _running = false;
+    if (!_serialPort) return;
+
+    // Close on the strand, then wait for the aborted operations: they still refer to this.
+    // No pacing timer is scheduled once _running is false: cancelling here is final.
+    asio::post(_strand, _ops.wrap([this]() {
+        Core::TimerScheduler::instance().cancel(_paceTimer);
+        _paceTimer = Core::TimerScheduler::InvalidTimer;
+
+        asio::error_code ignored;
+        if (_serialPort->is_open()) {
+            _serialPort->cancel(ignored);
+            _serialPort->close(ignored);
+        }
+    }));
+    _ops.waitIdle();
 
-    if (_serialPort && _serialPort->is_open()) {
-        _serialPort->cancel();
-        _serialPort->close();
-    }
-    _ioContext.stop();
-
-    if (_serviceThread.joinable()) {
-        _serviceThread.join();
-    }
-    
-    // Reset ioContext for potential restart
-    _ioContext.restart();
+    _serialPort.reset();
     _writeQueue.clear();
-    _isWriting = false;
+    _writing.reset();
 }
 
 void SerialService::startReceive() {
@@ -65,17 +74,16 @@ void SerialService::startReceive() {
 
     _serialPort->async_read_some(
         asio::buffer(_recvBuffer),
-        [this](const std::error_code& error, std::size_t bytes_transferred) {
+        _ops.wrap([this](const std::error_code& error, std::size_t bytes_transferred) {
             handleReceive(error, bytes_transferred);
-        }
+        })
     );
 }
 
 void SerialService::handleReceive(const std::error_code& error, std::size_t bytes_transferred) {
     if (!error) {
         if (bytes_transferred > 0 && _onDataReceived) {
-            std::vector<char> data(_recvBuffer.begin(), _recvBuffer.begin() + bytes_transferred);
-            _onDataReceived(data, _portName);
+            _onDataReceived(std::string_view(_recvBuffer.data(), bytes_transferred), _portName);
         }
         startReceive();
     } else {
@@ -87,40 +95,72 @@ void SerialService::handleReceive(const std::error_code& error, std::size_t byte
     }
 }
 
-void SerialService::send(const std::string& data) {
+void SerialService::send(const Core::SentenceRef& sentence) {
     if (!_running) return;
-    asio::post(_ioContext, [this, data]() {
-        doWrite(data);
-    });
+    _messages.fetch_add(1, std::memory_order_relaxed);
+    asio::post(_strand, _ops.wrap([this, sentence]() {
+        doWrite(sentence);
+    }));
 }
 
-void SerialService::doWrite(const std::string& data) {
-    _writeQueue.push_back(data);
-    if (!_isWriting) {
-        checkWriteQueue();
-    }
+TrafficStats SerialService::getTrafficStats() const {
+    TrafficStats stats;
+    stats.messages = _messages.load(std::memory_order_relaxed);
+    stats.packets = _packets.load(std::memory_order_relaxed);
+    stats.bytes = _bytes.load(std::memory_order_relaxed);
+    stats.dropped = _dropped.load(std::memory_order_relaxed) + _writeErrors.load(std::memory_order_relaxed);
+    stats.queued = _queued.load(std::memory_order_relaxed);
+    stats.superseded = _superseded.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SerialService::doWrite(Core::SentenceRef sentence) {
+    if (!_running) return;
+    _writeQueue.push(std::move(sentence));
+    checkWriteQueue();
 }
 
 void SerialService::checkWriteQueue() {
-    if (_writeQueue.empty()) {
-        _isWriting = false;
+    _queued.store(_writeQueue.size(), std::memory_order_relaxed);
+    _dropped.store(_writeQueue.getDropped(), std::memory_order_relaxed);
+    _superseded.store(_writeQueue.getSuperseded(), std::memory_order_relaxed);
+
+    if (!_running || _writing || _paceTimer != Core::TimerScheduler::InvalidTimer || _writeQueue.empty()) return;
+
+    // Link still busy: pick the sentence when it frees up, the freshest one by then
+    auto now = std::chrono::steady_clock::now();
+    if (_linkFreeAt > now + WriteLead) {
+        _paceTimer = Core::TimerScheduler::instance().scheduleAfter(_linkFreeAt - now - WriteLead, [this]() {
+            asio::post(_strand, _ops.wrap([this]() {
+                _paceTimer = Core::TimerScheduler::InvalidTimer;
+                checkWriteQueue();
+            }));
+        });
         return;
     }
 
-    _isWriting = true;
-    const std::string& msg = _writeQueue.front();
+    _writing = _writeQueue.pop();
+    _queued.store(_writeQueue.size(), std::memory_order_relaxed);
+    std::string_view msg = _writing.line();
+    _linkFreeAt = std::max(_linkFreeAt, now) +
+                  std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>(msg.size() / _bytesPerSecond));
 
-    asio::async_write(*_serialPort, asio::buffer(msg),
-        [this](const std::error_code& error, std::size_t /*bytes_transferred*/) {
+    asio::async_write(*_serialPort, asio::buffer(msg.data(), msg.size()),
+        _ops.wrap([this](const std::error_code& error, std::size_t bytes_transferred) {
+            _writing.reset();
             if (!_running) return;
             
             if (error) {
                 std::cerr << "Serial Write Error: " << error.message() << std::endl;
+                _writeErrors.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                _packets.fetch_add(1, std::memory_order_relaxed);
+                _bytes.fetch_add(bytes_transferred, std::memory_order_relaxed);
             }
 
-            _writeQueue.pop_front();
             checkWriteQueue();
-        });
+        }));
 }
 
 } // namespace Network
@@ -1,20 +1,28 @@
 #pragma once
 
 #include "IService.hpp"
+#include "IoRuntime.hpp"
+#include "SerialOutputQueue.hpp"
+#include "core/TimerScheduler.hpp"
 #include <asio.hpp>
-#include <thread>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <deque>
 
 namespace Network {
 
+// Serial port, read as a source and/or written as an output.
+// Writes are paced to the baud rate: a sentence is handed to the port only once the
+// previous ones are (nearly) on the wire, so the freshest data waits in SerialOutputQueue
+// rather than stale data in the driver buffer.
 class SerialService : public IService {
 public:
-    using DataCallback = std::function<void(const std::vector<char>&, const std::string&)>;
+    // 'data' points into the receive buffer and is only valid during the call
+    using DataCallback = std::function<void(std::string_view data, const std::string& source)>;
 
     SerialService(const std::string& portName, unsigned int baudRate, DataCallback callback);
     ~SerialService();
@@ -22,26 +30,45 @@ public:
     void start() override;
     void stop() override;
     bool isRunning() const override { return _running; }
-    void send(const std::string& data) override;
+    void send(const Core::SentenceRef& sentence) override;
+    TrafficStats getTrafficStats() const override;
+
+    // Most AIS data waiting to be written, in seconds of link time
+    static constexpr double MaxAisBacklogSeconds = 2.0;
+
+    // How far ahead of the wire a sentence may be handed to the port
+    static constexpr std::chrono::milliseconds WriteLead{20};
 
 private:
     void startReceive();
     void handleReceive(const std::error_code& error, std::size_t bytes_transferred);
-    void doWrite(const std::string& data);
+    void doWrite(Core::SentenceRef sentence);
     void checkWriteQueue();
 
     std::string _portName;
     unsigned int _baudRate;
     DataCallback _onDataReceived;
     
-    asio::io_context _ioContext;
+    IoRuntime::Strand _strand; // Serializes every handler of this port
+    PendingOps _ops;
     std::unique_ptr<asio::serial_port> _serialPort;
     std::vector<char> _recvBuffer;
     
-    std::deque<std::string> _writeQueue;
-    bool _isWriting = false;
+    // Output pacing, on the strand
+    double _bytesPerSecond;                         // 10 bits per byte (8N1)
+    SerialOutputQueue _writeQueue;
+    Core::SentenceRef _writing;                     // Held until written
+    std::chrono::steady_clock::time_point _linkFreeAt; // When the bytes written so far are sent
+    Core::TimerScheduler::TimerId _paceTimer = Core::TimerScheduler::InvalidTimer;
+
+    std::atomic<uint64_t> _messages{0};
+    std::atomic<uint64_t> _packets{0};
+    std::atomic<uint64_t> _bytes{0};
+    std::atomic<uint64_t> _dropped{0};     // By the queue
+    std::atomic<uint64_t> _writeErrors{0};
+    std::atomic<uint64_t> _queued{0};
+    std::atomic<uint64_t> _superseded{0};
 
-    std::thread _serviceThread;
     std::atomic<bool> _running{false};
 };
 
@@ -12,7 +12,7 @@ public:
     void start() override { _running = true; }
     void stop() override { _running = false; }
     bool isRunning() const override { return _running; }
-    void send(const std::string& data) override {} // Simulator doesn't accept input this way
+    void send(const Core::SentenceRef& sentence) override {} // Simulator doesn't accept input this way
 
 private:
     bool _running = true; // Default to true to avoid race condition at startup
@@ -0,0 +1,168 @@
+#include "TcpClient.hpp"
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <mstcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace Network {
+
+TcpClient::TcpClient(const std::string& host, int port, DataCallback callback, ConnectCallback onConnected)
+    : _host(host), _port(port), _label(host + ":" + std::to_string(port)),
+      _onDataReceived(std::move(callback)), _onConnected(std::move(onConnected)),
+      _strand(IoRuntime::instance().makeStrand()) {}
+
+TcpClient::~TcpClient() {
+    stop();
+}
+
+void TcpClient::start() {
+    if (_running) return;
+
+    _resolver = std::make_unique<asio::ip::tcp::resolver>(_strand);
+    _socket = std::make_unique<asio::ip::tcp::socket>(_strand);
+    _backoff = InitialBackoff;
+    _running = true;
+    asio::post(_strand, _ops.wrap([this]() { connect(); }));
+
+    _watchdogTimer = Core::TimerScheduler::instance().schedulePeriodic(WatchdogPeriod, [this]() {
+        asio::post(_strand, _ops.wrap([this]() { checkInactivity(); }));
+    }, WatchdogPeriod / 5);
+}
+
+void TcpClient::stop() {
+    if (!_running) return;
+    _running = false;
+
+    // Close on the strand, then wait for the aborted operations: they still refer to this.
+    // No reconnection is scheduled once _running is false: cancelling here is final.
+    asio::post(_strand, _ops.wrap([this]() {
+        Core::TimerScheduler::instance().cancel(_reconnectTimer);
+        _reconnectTimer = Core::TimerScheduler::InvalidTimer;
+        Core::TimerScheduler::instance().cancel(_watchdogTimer);
+        _watchdogTimer = Core::TimerScheduler::InvalidTimer;
+
+        asio::error_code ignored;
+        _resolver->cancel();
+        _socket->close(ignored);
+    }));
+    _ops.waitIdle();
+
+    _connected = false;
+    _socket.reset();
+    _resolver.reset();
+}
+
+void TcpClient::connect() {
+    if (!_running) return;
+
+    _resolver->async_resolve(_host, std::to_string(_port),
+        _ops.wrap([this](const std::error_code& error, asio::ip::tcp::resolver::results_type endpoints) {
+            if (!_running) return;
+            if (error) {
+                scheduleReconnect("resolve failed: " + error.message());
+                return;
+            }
+
+            asio::async_connect(*_socket, endpoints,
+                _ops.wrap([this](const std::error_code& error, const auto& /*endpoint*/) {
+                    if (!_running) return;
+                    if (error) {
+                        scheduleReconnect("connect failed: " + error.message());
+                        return;
+                    }
+
+                    // Small sentences, sent as they come: no Nagle delay. Keepalive detects
+                    // a gateway gone without a FIN (power loss, WiFi out of range).
+                    asio::error_code ignored;
+                    _socket->set_option(asio::ip::tcp::no_delay(true), ignored);
+                    setKeepAlive();
+
+                    std::cerr << "TCP Client connected to " << _label << std::endl;
+                    _backoff = InitialBackoff;
+                    _lastReceive = std::chrono::steady_clock::now();
+                    _connected = true;
+                    if (_onConnected) _onConnected();
+                    startReceive();
+                }));
+        }));
+}
+
+void TcpClient::startReceive() {
+    _socket->async_read_some(asio::buffer(_recvBuffer),
+        _ops.wrap([this](const std::error_code& error, std::size_t bytes_transferred) {
+            if (!_running) return;
+            if (error == asio::error::operation_aborted) return; // Closed by the watchdog, already reconnecting
+            if (error) {
+                _connected = false;
+                scheduleReconnect(error == asio::error::eof ? "closed by peer" : error.message());
+                return;
+            }
+
+            _lastReceive = std::chrono::steady_clock::now();
+            if (_onDataReceived) {
+                _onDataReceived(std::string_view(_recvBuffer.data(), bytes_transferred), _label);
+            }
+            startReceive();
+        }));
+}
+
+void TcpClient::scheduleReconnect(const std::string& reason) {
+    std::cerr << "TCP Client " << _label << ": " << reason << ", retrying in "
+              << _backoff.count() << " ms" << std::endl;
+
+    asio::error_code ignored;
+    _socket->close(ignored);
+
+    _reconnectTimer = Core::TimerScheduler::instance().scheduleAfter(_backoff, [this]() {
+        asio::post(_strand, _ops.wrap([this]() {
+            _reconnectTimer = Core::TimerScheduler::InvalidTimer;
+            connect();
+        }));
+    });
+    _backoff = std::min(_backoff * 2, MaxBackoff);
+}
+
+void TcpClient::setKeepAlive() {
+    asio::error_code ignored;
+    _socket->set_option(asio::socket_base::keep_alive(true), ignored);
+
+    // The system defaults only probe after 2 hours of silence
+    const int idle = static_cast<int>(KeepAliveIdle.count());
+    const int interval = static_cast<int>(KeepAliveInterval.count());
+#ifdef _WIN32
+    // The probe count is fixed by Windows (10)
+    tcp_keepalive values{};
+    values.onoff = 1;
+    values.keepalivetime = static_cast<ULONG>(idle * 1000);
+    values.keepaliveinterval = static_cast<ULONG>(interval * 1000);
+    DWORD returned = 0;
+    WSAIoctl(_socket->native_handle(), SIO_KEEPALIVE_VALS, &values, sizeof(values), nullptr, 0, &returned,
+             nullptr, nullptr);
+#else
+#if defined(TCP_KEEPIDLE)
+    _socket->set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPIDLE>(idle), ignored);
+#elif defined(TCP_KEEPALIVE)
+    _socket->set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPALIVE>(idle), ignored);
+#endif
+#if defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+    _socket->set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPINTVL>(interval), ignored);
+    _socket->set_option(asio::detail::socket_option::integer<IPPROTO_TCP, TCP_KEEPCNT>(KeepAliveCount), ignored);
+#endif
+#endif
+}
+
+void TcpClient::checkInactivity() {
+    if (!_running || !_connected) return;
+    if (std::chrono::steady_clock::now() - _lastReceive < InactivityTimeout) return;
+
+    // Connected but silent: the pending read is aborted, and ignored
+    _connected = false;
+    scheduleReconnect("no data for " + std::to_string(InactivityTimeout.count()) + " s");
+}
+
+} // namespace Network
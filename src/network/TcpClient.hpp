@@ -0,0 +1,79 @@
+#pragma once
+
+#include "IService.hpp"
+#include "IoRuntime.hpp"
+#include "core/TimerScheduler.hpp"
+#include <asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Network {
+
+// TCP client source: reads an NMEA stream from a gateway (WiFi multiplexer, AIS receiver).
+//
+// Connection losses are expected: the client reconnects on its own, waiting InitialBackoff
+// after the first failure and doubling the delay up to MaxBackoff. A successful connection
+// resets the delay. The stream has no message boundaries: feed it to a Parsers::NmeaFramer.
+//
+// A dead peer (power loss, out of WiFi range) is detected by TCP keepalive within about
+// KeepAliveIdle + KeepAliveCount * KeepAliveInterval. A peer still connected but silent
+// (stalled gateway) is dropped by a TimerScheduler watchdog after InactivityTimeout.
+class TcpClient : public IService {
+public:
+    // 'data' points into the receive buffer and is only valid during the call
+    using DataCallback = std::function<void(std::string_view data, const std::string& source)>;
+    // Called on each (re)connection, before its first data: drop partial sentences
+    using ConnectCallback = std::function<void()>;
+
+    static constexpr std::chrono::milliseconds InitialBackoff{500};
+    static constexpr std::chrono::milliseconds MaxBackoff{30000};
+    static constexpr size_t ReceiveBufferSize = 4096;
+    static constexpr std::chrono::seconds KeepAliveIdle{5};
+    static constexpr std::chrono::seconds KeepAliveInterval{2};
+    static constexpr int KeepAliveCount = 3;
+    static constexpr std::chrono::seconds InactivityTimeout{15}; // NMEA feeds send several sentences per second
+    static constexpr std::chrono::seconds WatchdogPeriod{5};
+
+    TcpClient(const std::string& host, int port, DataCallback callback, ConnectCallback onConnected = nullptr);
+    ~TcpClient();
+
+    void start() override;
+    void stop() override;
+    bool isRunning() const override { return _running; }
+    bool isConnected() const override { return _connected; }
+
+private:
+    void connect();
+    void startReceive();
+    void scheduleReconnect(const std::string& reason);
+    void setKeepAlive();
+    void checkInactivity();
+
+    std::string _host;
+    int _port;
+    std::string _label; // "host:port", passed to the callback
+    DataCallback _onDataReceived;
+    ConnectCallback _onConnected;
+
+    IoRuntime::Strand _strand; // Serializes every handler of this connection
+    PendingOps _ops;
+    std::unique_ptr<asio::ip::tcp::resolver> _resolver;
+    std::unique_ptr<asio::ip::tcp::socket> _socket;
+    std::array<char, ReceiveBufferSize> _recvBuffer;
+
+    // On the strand
+    std::chrono::milliseconds _backoff = InitialBackoff;
+    Core::TimerScheduler::TimerId _reconnectTimer = Core::TimerScheduler::InvalidTimer;
+    Core::TimerScheduler::TimerId _watchdogTimer = Core::TimerScheduler::InvalidTimer;
+    std::chrono::steady_clock::time_point _lastReceive;
+
+    std::atomic<bool> _connected{false};
+    std::atomic<bool> _running{false};
+};
+
+} // namespace Network
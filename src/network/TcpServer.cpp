@@ -0,0 +1,241 @@
+#include "TcpServer.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace Network {
+
+TcpServer::TcpServer(int port, size_t maxClients)
+    : _port(port), _maxClients(maxClients), _strand(IoRuntime::instance().makeStrand()) {}
+
+TcpServer::~TcpServer() {
+    stop();
+}
+
+void TcpServer::start() {
+    if (_running) return;
+
+    try {
+        _acceptor = std::make_unique<asio::ip::tcp::acceptor>(_strand);
+        asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v4(), static_cast<unsigned short>(_port));
+        _acceptor->open(endpoint.protocol());
+        _acceptor->set_option(asio::ip::tcp::acceptor::reuse_address(true));
+        _acceptor->bind(endpoint);
+        _acceptor->listen();
+
+        _messages = 0;
+        _packets = 0;
+        _bytes = 0;
+        _dropped = 0;
+        _running = true;
+        asio::post(_strand, _ops.wrap([this]() { startAccept(); }));
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to start TCP Server on port " << _port << ": " << e.what() << std::endl;
+        _acceptor.reset();
+        _running = false;
+    }
+}
+
+void TcpServer::stop() {
+    if (!_running) return;
+    _running = false;
+
+    // Close on the strand, then wait for the aborted operations: they still refer to this
+    asio::post(_strand, _ops.wrap([this]() {
+        asio::error_code ignored;
+        if (_acceptor && _acceptor->is_open()) _acceptor->close(ignored);
+
+        std::vector<std::shared_ptr<Client>> clients;
+        {
+            std::lock_guard<std::mutex> lock(_clientsMutex);
+            clients.swap(_clients);
+        }
+        for (auto& client : clients) {
+            client->closed = true;
+            client->socket.close(ignored);
+        }
+    }));
+    _ops.waitIdle();
+
+    _acceptor.reset();
+}
+
+void TcpServer::startAccept() {
+    if (!_running) return;
+
+    _acceptor->async_accept(_ops.wrap([this](const std::error_code& error, asio::ip::tcp::socket socket) {
+        if (!_running) return;
+
+        if (error) {
+            if (error != asio::error::operation_aborted) {
+                std::cerr << "TCP Accept Error: " << error.message() << std::endl;
+            }
+        } else {
+            auto client = std::make_shared<Client>(std::move(socket));
+            client->connectedAt = std::chrono::steady_clock::now();
+
+            asio::error_code ignored;
+            auto remote = client->socket.remote_endpoint(ignored);
+            client->address = remote.address().to_string(ignored) + ":" + std::to_string(remote.port());
+
+            std::lock_guard<std::mutex> lock(_clientsMutex);
+            if (_clients.size() >= _maxClients) {
+                std::cerr << "TCP Server: refusing " << client->address << ", " << _maxClients << " clients already" << std::endl;
+                client->socket.close(ignored);
+            } else {
+                client->socket.set_option(asio::ip::tcp::no_delay(true), ignored);
+                _clients.push_back(client);
+                startRead(client);
+            }
+        }
+        startAccept();
+    }));
+}
+
+// Clients don't send anything we use: reading only detects disconnections
+void TcpServer::startRead(const std::shared_ptr<Client>& client) {
+    client->socket.async_read_some(asio::buffer(client->readBuffer),
+        _ops.wrap([this, client](const std::error_code& error, std::size_t /*bytes_transferred*/) {
+            if (!_running || client->closed) return;
+
+            if (error) {
+                disconnect(client, error == asio::error::eof ? nullptr : "read error");
+                return;
+            }
+            startRead(client);
+        }));
+}
+
+void TcpServer::send(const Core::SentenceRef& sentence) {
+    if (!_running) return;
+    _messages.fetch_add(1, std::memory_order_relaxed);
+
+    asio::post(_strand, _ops.wrap([this, sentence]() {
+        fanOut(sentence);
+    }));
+}
+
+void TcpServer::fanOut(const Core::SentenceRef& sentence) {
+    if (!_running) return;
+
+    size_t length = sentence.line().size();
+    auto now = std::chrono::steady_clock::now();
+
+    // Only the strand modifies _clients, so it reads them without the lock.
+    // disconnect() erases from the vector: index based, the next client takes the slot.
+    for (size_t i = 0; i < _clients.size();) {
+        Client& client = *_clients[i];
+        if (client.queuedBytes + length > MaxClientBacklog) {
+            client.dropped.fetch_add(1, std::memory_order_relaxed);
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+
+            if (client.fullSince == std::chrono::steady_clock::time_point{}) {
+                client.fullSince = now;
+            } else if (now - client.fullSince >= StallTimeout) {
+                std::shared_ptr<Client> stalled = _clients[i]; // Not a reference into the vector
+                disconnect(stalled, "stalled");
+                continue;
+            }
+            ++i;
+            continue;
+        }
+
+        client.fullSince = {};
+        client.queue.push_back(sentence);
+        client.queuedBytes += length;
+        client.queued.store(client.queue.size(), std::memory_order_relaxed);
+        writeNext(_clients[i]);
+        ++i;
+    }
+}
+
+void TcpServer::writeNext(const std::shared_ptr<Client>& client) {
+    if (client->writing > 0 || client->queue.empty() || client->closed) return;
+
+    // Gather the queued sentences into one write
+    client->buffers.clear();
+    for (size_t i = 0; i < client->queue.size() && i < MaxWriteBatch; ++i) {
+        std::string_view line = client->queue[i].line();
+        client->buffers.emplace_back(line.data(), line.size());
+    }
+    client->writing = client->buffers.size();
+
+    asio::async_write(client->socket, client->buffers,
+        _ops.wrap([this, client](const std::error_code& error, std::size_t bytes_transferred) {
+            size_t count = std::exchange(client->writing, 0);
+            if (!_running || client->closed) return;
+
+            if (error) {
+                disconnect(client, "write error");
+                return;
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                client->queuedBytes -= client->queue.front().line().size();
+                client->queue.pop_front();
+            }
+            client->queued.store(client->queue.size(), std::memory_order_relaxed);
+            client->messages.fetch_add(count, std::memory_order_relaxed);
+            client->bytes.fetch_add(bytes_transferred, std::memory_order_relaxed);
+            client->writes.fetch_add(1, std::memory_order_relaxed);
+            _packets.fetch_add(1, std::memory_order_relaxed);
+            _bytes.fetch_add(bytes_transferred, std::memory_order_relaxed);
+
+            writeNext(client);
+        }));
+}
+
+// 'reason' null: closed by the client
+void TcpServer::disconnect(const std::shared_ptr<Client>& client, const char* reason) {
+    if (client->closed) return;
+    client->closed = true;
+
+    if (reason) {
+        std::cerr << "TCP Server: disconnecting " << client->address << " (" << reason << ")" << std::endl;
+    }
+
+    asio::error_code ignored;
+    client->socket.close(ignored);
+
+    // Sentences still queued are lost. The queue itself goes with the client, once the
+    // aborted write (which refers to it) has completed.
+    client->dropped.fetch_add(client->queue.size(), std::memory_order_relaxed);
+    _dropped.fetch_add(client->queue.size(), std::memory_order_relaxed);
+    client->queued.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_clientsMutex);
+    _clients.erase(std::remove(_clients.begin(), _clients.end(), client), _clients.end());
+}
+
+TrafficStats TcpServer::getTrafficStats() const {
+    TrafficStats stats;
+    stats.messages = _messages.load(std::memory_order_relaxed);
+    stats.packets = _packets.load(std::memory_order_relaxed);
+    stats.bytes = _bytes.load(std::memory_order_relaxed);
+    stats.dropped = _dropped.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_clientsMutex);
+    for (const auto& client : _clients) {
+        stats.queued += client->queued.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+std::vector<PeerStats> TcpServer::getPeerStats() const {
+    std::lock_guard<std::mutex> lock(_clientsMutex);
+    std::vector<PeerStats> peers;
+    peers.reserve(_clients.size());
+    for (const auto& client : _clients) {
+        PeerStats peer;
+        peer.address = client->address;
+        peer.connectedAt = client->connectedAt;
+        peer.traffic.messages = client->messages.load(std::memory_order_relaxed);
+        peer.traffic.packets = client->writes.load(std::memory_order_relaxed);
+        peer.traffic.bytes = client->bytes.load(std::memory_order_relaxed);
+        peer.traffic.dropped = client->dropped.load(std::memory_order_relaxed);
+        peer.traffic.queued = client->queued.load(std::memory_order_relaxed);
+        peers.push_back(std::move(peer));
+    }
+    return peers;
+}
+
+} // namespace Network
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "IService.hpp"
+#include "IoRuntime.hpp"
+#include <asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Network {
+
+// TCP server output: every connected client receives the stream (e.g. OpenCPN on port 10110).
+//
+// Each client has its own bounded write queue. A slow client loses sentences once its queue
+// is full, and is disconnected if it stays full for StallTimeout: it never holds back
+// the other clients or the sources.
+class TcpServer : public IService {
+public:
+    static constexpr size_t MaxClientBacklog = 64 * 1024;  // Bytes queued per client
+    static constexpr std::chrono::seconds StallTimeout{10};
+    static constexpr size_t MaxWriteBatch = 64;            // Sentences per write
+
+    TcpServer(int port, size_t maxClients = 16);
+    ~TcpServer();
+
+    void start() override;
+    void stop() override;
+    bool isRunning() const override { return _running; }
+    void send(const Core::SentenceRef& sentence) override;
+    TrafficStats getTrafficStats() const override;
+    std::vector<PeerStats> getPeerStats() const override;
+
+private:
+    struct Client {
+        explicit Client(asio::ip::tcp::socket s) : socket(std::move(s)) {}
+
+        asio::ip::tcp::socket socket;
+        std::string address;
+        std::chrono::steady_clock::time_point connectedAt;
+
+        // On the strand
+        std::deque<Core::SentenceRef> queue;
+        size_t queuedBytes = 0;
+        size_t writing = 0; // Sentences of the write in progress, at the front of the queue
+        std::vector<asio::const_buffer> buffers;
+        std::chrono::steady_clock::time_point fullSince{}; // Epoch: queue not full
+        std::array<char, 256> readBuffer;                  // Input is discarded
+        bool closed = false;
+
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> writes{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> queued{0};
+    };
+
+    void startAccept();
+    void startRead(const std::shared_ptr<Client>& client);
+    void fanOut(const Core::SentenceRef& sentence);
+    void writeNext(const std::shared_ptr<Client>& client);
+    void disconnect(const std::shared_ptr<Client>& client, const char* reason);
+
+    int _port;
+    size_t _maxClients;
+
+    IoRuntime::Strand _strand; // Serializes the acceptor and every client
+    PendingOps _ops;
+    std::unique_ptr<asio::ip::tcp::acceptor> _acceptor;
+
+    // Only modified on the strand, which reads it without locking. The lock is for the
+    // readers on other threads (getTrafficStats(), getPeerStats()).
+    mutable std::mutex _clientsMutex;
+    std::vector<std::shared_ptr<Client>> _clients;
+
+    std::atomic<uint64_t> _messages{0};
+    std::atomic<uint64_t> _packets{0};
+    std::atomic<uint64_t> _bytes{0};
+    std::atomic<uint64_t> _dropped{0};
+
+    std::atomic<bool> _running{false};
+};
+
+} // namespace Network
@@ -1,9 +1,18 @@
 #include "UdpSender.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 namespace Network {
 
-UdpSender::UdpSender(const std::string& address, int port) 
-    : _targetAddress(address), _targetPort(port) {}
+UdpSender::UdpSender(const std::string& address, int port, size_t maxDatagram, std::chrono::milliseconds flushDelay)
+    : _targetAddress(address), _targetPort(port), _maxDatagram(maxDatagram), _flushDelay(flushDelay),
+      _strand(IoRuntime::instance().makeStrand()) {}
 
 UdpSender::~UdpSender() {
     stop();
@@ -13,21 +22,16 @@ void UdpSender::start() {
     if (_running) return;
 
     try {
-        _socket = std::make_unique<asio::ip::udp::socket>(_ioContext);
+        _socket = std::make_unique<asio::ip::udp::socket>(_strand);
         _socket->open(asio::ip::udp::v4());
-        
+
         _remoteEndpoint = asio::ip::udp::endpoint(asio::ip::make_address(_targetAddress), _targetPort);
-        
-        _running = true;
 
-        _serviceThread = std::thread([this]() {
-            try {
-                asio::io_context::work work(_ioContext); // Keep io_context alive
-                _ioContext.run();
-            } catch (const std::exception& e) {
-                std::cerr << "UDP Sender Error: " << e.what() << std::endl;
-            }
-        });
+        _messages = 0;
+        _packets = 0;
+        _bytes = 0;
+        _dropped = 0;
+        _running = true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to start UDP Sender: " << e.what() << std::endl;
         _running = false;
@@ -38,29 +42,76 @@ void UdpSender::stop() {
     if (!_running) return;
     _running = false;
 
-    _ioContext.stop();
-    if (_serviceThread.joinable()) {
-        _serviceThread.join();
+    // No new flush timer once _running is false (checked under the same lock by send())
+    Core::TimerScheduler::TimerId flushTimer;
+    {
+        std::lock_guard<std::mutex> lock(_batchMutex);
+        flushTimer = _flushTimer;
+        _flushTimer = Core::TimerScheduler::InvalidTimer;
     }
-    
-    if (_socket && _socket->is_open()) {
-        _socket->close();
-    }
-    
-    _ioContext.restart();
+    Core::TimerScheduler::instance().cancel(flushTimer);
+
+    // Close on the strand, then wait for queued and aborted sends: they still refer to this
+    asio::post(_strand, _ops.wrap([this]() {
+        asio::error_code ignored;
+        if (_socket && _socket->is_open()) {
+            _socket->close(ignored);
+        }
+    }));
+    _ops.waitIdle();
+
+    _socket.reset();
     _sendQueue.clear();
     _isSending = false;
+    _datagram.clear();
+    _ready.clear();
+    _flushPosted = false;
 }
 
-void UdpSender::send(const std::string& data) {
+void UdpSender::send(const Core::SentenceRef& sentence) {
+    if (!_running) return;
+    _messages.fetch_add(1, std::memory_order_relaxed);
+
+    if (_maxDatagram == 0) {
+        asio::post(_strand, _ops.wrap([this, sentence]() {
+            doSend(sentence);
+        }));
+        return;
+    }
+
+    std::string_view data = sentence.line();
+
+    std::lock_guard<std::mutex> lock(_batchMutex);
     if (!_running) return;
-    asio::post(_ioContext, [this, data]() {
-        doSend(data);
-    });
+
+    if (!_datagram.empty() && _datagram.size() + data.size() > _maxDatagram) {
+        sealDatagram();
+    }
+    _datagram += data;
+
+    if (_datagram.size() >= _maxDatagram) {
+        sealDatagram();
+    } else if (_flushTimer == Core::TimerScheduler::InvalidTimer) {
+        // First sentence of this datagram: bounds its latency
+        _flushTimer = Core::TimerScheduler::instance().scheduleAfter(_flushDelay, [this]() {
+            std::lock_guard<std::mutex> lock(_batchMutex);
+            _flushTimer = Core::TimerScheduler::InvalidTimer;
+            if (!_datagram.empty()) sealDatagram();
+        });
+    }
+}
+
+TrafficStats UdpSender::getTrafficStats() const {
+    TrafficStats stats;
+    stats.messages = _messages.load(std::memory_order_relaxed);
+    stats.packets = _packets.load(std::memory_order_relaxed);
+    stats.bytes = _bytes.load(std::memory_order_relaxed);
+    stats.dropped = _dropped.load(std::memory_order_relaxed);
+    return stats;
 }
 
-void UdpSender::doSend(const std::string& data) {
-    _sendQueue.push_back(data);
+void UdpSender::doSend(Core::SentenceRef sentence) {
+    _sendQueue.push_back(std::move(sentence));
     if (!_isSending) {
         checkSendQueue();
     }
@@ -73,19 +124,117 @@ void UdpSender::checkSendQueue() {
     }
 
     _isSending = true;
-    const std::string& msg = _sendQueue.front();
+    std::string_view msg = _sendQueue.front().line();
 
-    _socket->async_send_to(asio::buffer(msg), _remoteEndpoint,
-        [this](const std::error_code& error, std::size_t /*bytes_transferred*/) {
+    _socket->async_send_to(asio::buffer(msg.data(), msg.size()), _remoteEndpoint,
+        _ops.wrap([this](const std::error_code& error, std::size_t bytes_transferred) {
             if (!_running) return;
-            
+
             if (error) {
                 std::cerr << "UDP Send Error: " << error.message() << std::endl;
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                _packets.fetch_add(1, std::memory_order_relaxed);
+                _bytes.fetch_add(bytes_transferred, std::memory_order_relaxed);
             }
 
             _sendQueue.pop_front();
             checkSendQueue();
-        });
+        }));
+}
+
+// Called with _batchMutex held
+void UdpSender::sealDatagram() {
+    _ready.push_back(std::move(_datagram));
+    if (!_spare.empty()) {
+        _datagram = std::move(_spare.back());
+        _spare.pop_back();
+    } else {
+        _datagram = std::string();
+        _datagram.reserve(_maxDatagram);
+    }
+    _datagram.clear();
+
+    if (!_flushPosted) {
+        _flushPosted = true;
+        asio::post(_strand, _ops.wrap([this]() { flushReady(); }));
+    }
+}
+
+void UdpSender::flushReady() {
+    std::vector<std::string> datagrams;
+    {
+        std::lock_guard<std::mutex> lock(_batchMutex);
+        datagrams.swap(_ready);
+        _flushPosted = false;
+    }
+
+    if (_running && _socket && _socket->is_open()) {
+        for (size_t offset = 0; offset < datagrams.size(); offset += BatchSize) {
+            size_t count = std::min(BatchSize, datagrams.size() - offset);
+            size_t sent = submit(&datagrams[offset], count);
+            for (size_t i = offset; i < offset + count; ++i) {
+                if (i - offset < sent) {
+                    _packets.fetch_add(1, std::memory_order_relaxed);
+                    _bytes.fetch_add(datagrams[i].size(), std::memory_order_relaxed);
+                } else {
+                    // Count lost sentences, not datagrams
+                    _dropped.fetch_add(std::count(datagrams[i].begin(), datagrams[i].end(), '\n'), std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // Recycle the buffers
+    std::lock_guard<std::mutex> lock(_batchMutex);
+    for (auto& datagram : datagrams) {
+        if (_spare.size() >= MaxSpare) break;
+        datagram.clear();
+        _spare.push_back(std::move(datagram));
+    }
+}
+
+// Sends up to BatchSize datagrams without blocking the runtime thread, returns how many went out
+size_t UdpSender::submit(const std::string* datagrams, size_t count) {
+#ifdef __linux__
+    mmsghdr messages[BatchSize];
+    iovec iovecs[BatchSize];
+    for (size_t i = 0; i < count; ++i) {
+        iovecs[i] = {const_cast<char*>(datagrams[i].data()), datagrams[i].size()};
+        messages[i] = {};
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = _remoteEndpoint.data();
+        messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(_remoteEndpoint.size());
+    }
+
+    const int fd = _socket->native_handle();
+    size_t sent = 0;
+    while (sent < count) {
+        int result = ::sendmmsg(fd, messages + sent, static_cast<unsigned int>(count - sent), MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "UDP Send Error: " << std::strerror(errno) << std::endl;
+            }
+            break; // Send buffer full: the rest of the batch is dropped
+        }
+        sent += result;
+    }
+    return sent;
+#else
+    size_t sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        asio::error_code error;
+        _socket->send_to(asio::buffer(datagrams[i]), _remoteEndpoint, 0, error);
+        if (error) {
+            std::cerr << "UDP Send Error: " << error.message() << std::endl;
+            break;
+        }
+        sent++;
+    }
+    return sent;
+#endif
 }
 
 } // namespace Network
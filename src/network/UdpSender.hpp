@@ -1,40 +1,74 @@
 #pragma once
 
 #include "IService.hpp"
+#include "IoRuntime.hpp"
+#include "core/TimerScheduler.hpp"
 #include <asio.hpp>
-#include <thread>
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <deque>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 namespace Network {
 
+// UDP output. By default every send() is one datagram.
+//
+// In coalescing mode, sentences are packed into datagrams of at most 'maxDatagram' bytes
+// (a longer sentence goes alone). A datagram leaves when full, or 'flushDelay' after its
+// first sentence. Full datagrams are submitted in batches (sendmmsg on Linux).
 class UdpSender : public IService {
 public:
-    UdpSender(const std::string& address, int port);
+    UdpSender(const std::string& address, int port,
+              size_t maxDatagram = 0, std::chrono::milliseconds flushDelay = std::chrono::milliseconds(0));
     ~UdpSender();
 
     void start() override;
     void stop() override;
     bool isRunning() const override { return _running; }
-    void send(const std::string& data) override;
+    void send(const Core::SentenceRef& sentence) override;
+    TrafficStats getTrafficStats() const override;
 
 private:
-    void doSend(const std::string& data);
+    static constexpr size_t BatchSize = 32;  // Datagrams per sendmmsg call
+    static constexpr size_t MaxSpare = 64;   // Datagram buffers kept for reuse
+
+    void doSend(Core::SentenceRef sentence);
     void checkSendQueue();
 
+    // Coalescing mode
+    void sealDatagram();
+    void flushReady();
+    size_t submit(const std::string* datagrams, size_t count);
+
     std::string _targetAddress;
     int _targetPort;
+    size_t _maxDatagram;
+    std::chrono::milliseconds _flushDelay;
     
-    asio::io_context _ioContext;
+    IoRuntime::Strand _strand; // Serializes every handler of this socket
+    PendingOps _ops;
     std::unique_ptr<asio::ip::udp::socket> _socket;
     asio::ip::udp::endpoint _remoteEndpoint;
     
-    std::deque<std::string> _sendQueue;
+    std::deque<Core::SentenceRef> _sendQueue;
     bool _isSending = false;
 
-    std::thread _serviceThread;
+    // Coalescing mode, filled by any thread under _batchMutex
+    std::mutex _batchMutex;
+    std::string _datagram;              // Being filled
+    std::vector<std::string> _ready;    // Sealed, waiting for flushReady() on the strand
+    std::vector<std::string> _spare;
+    bool _flushPosted = false;
+    Core::TimerScheduler::TimerId _flushTimer = Core::TimerScheduler::InvalidTimer;
+
+    std::atomic<uint64_t> _messages{0};
+    std::atomic<uint64_t> _packets{0};
+    std::atomic<uint64_t> _bytes{0};
+    std::atomic<uint64_t> _dropped{0};
+
     std::atomic<bool> _running{false};
 };
 
@@ -1,33 +1,72 @@
 #include "UdpService.hpp"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#endif
 
 namespace Network {
 
-UdpService::UdpService(int p, DataCallback callback) 
-    : _port(p), _onDataReceived(callback), _recvBuffer(4096) { // 4KB buffer
+UdpService::UdpService(int p, DataCallback callback, UdpListenOptions options)
+    : _port(p), _onDataReceived(callback), _options(std::move(options)), _receiverCount(receiverCount(_options)) {
+    if (_options.receivers > _receiverCount) {
+        std::cerr << "UDP port " << _port << ": several receivers need a unicast, unshared port, using one" << std::endl;
+    }
 }
 
 UdpService::~UdpService() {
     stop();
 }
 
+size_t UdpService::receiverCount(const UdpListenOptions& options) {
+#ifdef SO_REUSEPORT
+    if (options.shared || !options.multicastGroup.empty()) return 1;
+    return options.receivers == 0 ? 1 : options.receivers;
+#else
+    (void)options;
+    return 1;
+#endif
+}
+
 void UdpService::start() {
     if (_running) return;
     _running = true;
 
     try {
-        _socket = std::make_unique<asio::ip::udp::socket>(_ioContext, asio::ip::udp::endpoint(asio::ip::udp::v4(), _port));
-        startReceive();
-
-        _serviceThread = std::thread([this]() {
-            try {
-                _ioContext.run();
-            } catch (const std::exception& e) {
-                std::cerr << "UDP Service Error: " << e.what() << std::endl;
+        _sourceFilter = _options.sourceFilter.empty() ? 0 : asio::ip::make_address_v4(_options.sourceFilter).to_uint();
+
+        for (size_t i = 0; i < _receiverCount; ++i) {
+            auto receiver = std::make_unique<Receiver>(IoRuntime::instance().makeStrand(), i);
+            receiver->buffer.resize(BatchSize * MaxDatagram);
+
+            receiver->socket = std::make_unique<asio::ip::udp::socket>(receiver->strand);
+            openSocket(*receiver->socket);
+
+#ifdef __linux__
+            receiver->messages.resize(BatchSize);
+            receiver->iovecs.resize(BatchSize);
+            receiver->addresses.resize(BatchSize);
+            for (size_t slot = 0; slot < BatchSize; ++slot) {
+                receiver->iovecs[slot] = {receiver->buffer.data() + slot * MaxDatagram, MaxDatagram};
+                msghdr& header = receiver->messages[slot].msg_hdr;
+                header = {};
+                header.msg_iov = &receiver->iovecs[slot];
+                header.msg_iovlen = 1;
+                header.msg_name = &receiver->addresses[slot];
             }
-        });
+#endif
+            _receivers.push_back(std::move(receiver));
+        }
+
+        for (auto& receiver : _receivers) {
+            Receiver* r = receiver.get();
+            asio::post(r->strand, _ops.wrap([this, r]() { startReceive(*r); }));
+        }
     } catch (const std::exception& e) {
         std::cerr << "Failed to start UDP Service: " << e.what() << std::endl;
         _running = false;
+        _receivers.clear(); // Nothing was posted yet
     }
 }
 
@@ -35,43 +74,150 @@ void UdpService::stop() {
     if (!_running) return;
     _running = false;
 
-    if (_socket) {
-        _socket->close();
+    // Close on the strands, then wait for the aborted receives: they still refer to this
+    for (auto& receiver : _receivers) {
+        Receiver* r = receiver.get();
+        asio::post(r->strand, _ops.wrap([r]() {
+            asio::error_code ignored;
+            r->socket->close(ignored);
+        }));
     }
-    _ioContext.stop();
+    _ops.waitIdle();
+    _receivers.clear();
+}
+
+#ifdef __linux__
 
-    if (_serviceThread.joinable()) {
-        _serviceThread.join();
+void UdpService::startReceive(Receiver& receiver) {
+    if (!_running) return;
+
+    // Wait for readability only, then drain the socket with recvmmsg
+    receiver.socket->async_wait(asio::ip::udp::socket::wait_read,
+        _ops.wrap([this, &receiver](const std::error_code& error) {
+            handleReceive(receiver, error, 0);
+        })
+    );
+}
+
+void UdpService::handleReceive(Receiver& receiver, const std::error_code& error, std::size_t /*bytes_transferred*/) {
+    if (!error) {
+        receiveBatches(receiver);
+        startReceive(receiver); // Continue listening
+    } else {
+        if (error != asio::error::operation_aborted) {
+            std::cerr << "UDP Receive Error: " << error.message() << std::endl;
+            // Try to restart receive if it wasn't a stop command
+            if (_running) startReceive(receiver); 
+        }
     }
 }
 
-void UdpService::startReceive() {
-    if (!_running || !_socket) return;
+void UdpService::receiveBatches(Receiver& receiver) {
+    const int fd = receiver.socket->native_handle();
+
+    for (size_t batch = 0; batch < MaxBatchesPerWakeup && _running; ++batch) {
+        for (auto& message : receiver.messages) {
+            message.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+
+        int count = ::recvmmsg(fd, receiver.messages.data(), BatchSize, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "UDP Receive Error: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const mmsghdr& message = receiver.messages[i];
+            if (message.msg_len == 0 || !_onDataReceived) continue;
 
-    _socket->async_receive_from(
-        asio::buffer(_recvBuffer), _remoteEndpoint,
-        [this](const std::error_code& error, std::size_t bytes_transferred) {
-            handleReceive(error, bytes_transferred);
+            const auto* from = reinterpret_cast<const sockaddr_in*>(&receiver.addresses[i]);
+            uint32_t address = ntohl(from->sin_addr.s_addr);
+            if (_sourceFilter != 0 && address != _sourceFilter) continue;
+
+            std::string_view data(receiver.buffer.data() + i * MaxDatagram, message.msg_len);
+            _onDataReceived(data, sourceName(receiver, address, ntohs(from->sin_port)), receiver.index);
         }
+
+        if (static_cast<size_t>(count) < BatchSize) return; // Drained
+    }
+}
+
+#else
+
+void UdpService::startReceive(Receiver& receiver) {
+    if (!_running) return;
+
+    receiver.socket->async_receive_from(
+        asio::buffer(receiver.buffer.data(), MaxDatagram), receiver.remoteEndpoint,
+        _ops.wrap([this, &receiver](const std::error_code& error, std::size_t bytes_transferred) {
+            handleReceive(receiver, error, bytes_transferred);
+        })
     );
 }
 
-void UdpService::handleReceive(const std::error_code& error, std::size_t bytes_transferred) {
+void UdpService::handleReceive(Receiver& receiver, const std::error_code& error, std::size_t bytes_transferred) {
     if (!error) {
-        if (bytes_transferred > 0 && _onDataReceived) {
-            // Create a copy of the data to pass to callback
-            std::vector<char> data(_recvBuffer.begin(), _recvBuffer.begin() + bytes_transferred);
-            std::string source = _remoteEndpoint.address().to_string() + ":" + std::to_string(_remoteEndpoint.port());
-            _onDataReceived(data, source);
+        const auto& endpoint = receiver.remoteEndpoint;
+        uint32_t address = endpoint.address().to_v4().to_uint();
+        if (bytes_transferred > 0 && _onDataReceived && (_sourceFilter == 0 || address == _sourceFilter)) {
+            _onDataReceived(std::string_view(receiver.buffer.data(), bytes_transferred),
+                            sourceName(receiver, address, endpoint.port()), receiver.index);
         }
-        startReceive(); // Continue listening
+        startReceive(receiver); // Continue listening
     } else {
         if (error != asio::error::operation_aborted) {
             std::cerr << "UDP Receive Error: " << error.message() << std::endl;
             // Try to restart receive if it wasn't a stop command
-            if (_running) startReceive(); 
+            if (_running) startReceive(receiver); 
         }
     }
 }
 
+#endif
+
+void UdpService::openSocket(asio::ip::udp::socket& socket) {
+    socket.open(asio::ip::udp::v4());
+
+    // Several receivers of this service, or other programs, on the same port
+    if (_options.shared || !_options.multicastGroup.empty() || _receiverCount > 1) {
+        socket.set_option(asio::socket_base::reuse_address(true));
+#ifdef SO_REUSEPORT
+        socket.set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+#endif
+    }
+
+    asio::ip::address_v4 interfaceAddress = _options.interfaceAddress.empty()
+        ? asio::ip::address_v4::any() : asio::ip::make_address_v4(_options.interfaceAddress);
+
+    if (!_options.multicastGroup.empty()) {
+        asio::ip::address_v4 group = asio::ip::make_address_v4(_options.multicastGroup);
+#ifdef _WIN32
+        socket.bind(asio::ip::udp::endpoint(asio::ip::address_v4::any(), _port));
+#else
+        // Bound to the group: other traffic to this port is not delivered here
+        socket.bind(asio::ip::udp::endpoint(group, _port));
+#endif
+        socket.set_option(asio::ip::multicast::join_group(group, interfaceAddress));
+    } else {
+        // Bound to an interface address, broadcasts are not received on Linux: leave it empty for them
+        socket.bind(asio::ip::udp::endpoint(interfaceAddress, _port));
+    }
+
+    // Absorb bursts while the runtime threads are busy (capped by the system limit)
+    asio::error_code ignored;
+    socket.set_option(asio::socket_base::receive_buffer_size(ReceiveBufferSize), ignored);
+}
+
+const std::string& UdpService::sourceName(Receiver& receiver, uint32_t address, uint16_t port) {
+    uint64_t key = (static_cast<uint64_t>(address) << 16) | port;
+    auto it = receiver.sources.find(key);
+    if (it != receiver.sources.end()) return it->second;
+
+    if (receiver.sources.size() >= MaxCachedSources) receiver.sources.clear();
+    std::string name = asio::ip::address_v4(address).to_string() + ":" + std::to_string(port);
+    return receiver.sources.emplace(key, std::move(name)).first->second;
+}
+
 } // namespace Network
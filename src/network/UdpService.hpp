@@ -1,20 +1,54 @@
 #pragma once
 
 #include "IService.hpp"
+#include "IoRuntime.hpp"
 #include <asio.hpp>
-#include <thread>
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
 namespace Network {
 
+// Where and from whom a UdpService receives. Addresses are IPv4, empty means "any".
+struct UdpListenOptions {
+    std::string multicastGroup;   // Joined on start, e.g. "239.192.0.1"
+    std::string interfaceAddress; // Local address: interface of the multicast join, else bound address
+    std::string sourceFilter;     // Only datagrams sent from this address are kept
+    bool shared = false;          // SO_REUSEADDR/SO_REUSEPORT, so other programs can bind the port too
+
+    // Sockets of this service on the port (SO_REUSEPORT): the kernel spreads the peers over
+    // them, each peer always reaching the same one. Unicast, unshared ports only: other
+    // sockets on the port would each get a copy of broadcast and multicast datagrams.
+    size_t receivers = 1;
+};
+
+// UDP input, unicast, broadcast or multicast.
+//
+// Every socket bound to a shared port gets its own copy of broadcast and multicast
+// datagrams: several programs (or NavOne instances) can follow the same feed. Unicast
+// datagrams are delivered to one socket only.
 class UdpService : public IService {
 public:
-    using DataCallback = std::function<void(const std::vector<char>&, const std::string&)>;
+    // 'data' points into the receive buffer and is only valid during the call.
+    // Calls of one receiver (0 to getReceiverCount() - 1) are serialized, receivers run concurrently.
+    using DataCallback = std::function<void(std::string_view data, const std::string& source, size_t receiver)>;
 
-    UdpService(int port, DataCallback callback);
+    UdpService(int port, DataCallback callback, UdpListenOptions options = {});
+
+    // Receivers opened for these options: 1 on multicast or shared ports, or without SO_REUSEPORT
+    static size_t receiverCount(const UdpListenOptions& options);
+    size_t getReceiverCount() const { return _receiverCount; }
     ~UdpService();
 
     void start() override;
@@ -22,18 +56,46 @@ public:
     bool isRunning() const override { return _running; }
 
 private:
-    void startReceive();
-    void handleReceive(const std::error_code& error, std::size_t bytes_transferred);
+    static constexpr size_t MaxDatagram = 4096;
+    static constexpr size_t BatchSize = 32;            // Datagrams per recvmmsg call
+    static constexpr size_t MaxBatchesPerWakeup = 8;   // Then give the runtime thread back
+    static constexpr size_t MaxCachedSources = 1024;
+    static constexpr int ReceiveBufferSize = 4 * 1024 * 1024;
+
+    // One socket bound to the port, with its own strand and receive slab
+    struct Receiver {
+        Receiver(IoRuntime::Strand s, size_t i) : strand(std::move(s)), index(i) {}
+
+        IoRuntime::Strand strand;
+        size_t index;
+        std::unique_ptr<asio::ip::udp::socket> socket;
+        std::vector<char> buffer; // BatchSize slots of MaxDatagram bytes
+        asio::ip::udp::endpoint remoteEndpoint;
+        std::unordered_map<uint64_t, std::string> sources; // "address:port" by peer
+#ifdef __linux__
+        std::vector<mmsghdr> messages;
+        std::vector<iovec> iovecs;
+        std::vector<sockaddr_storage> addresses;
+#endif
+    };
+
+    void startReceive(Receiver& receiver);
+    void handleReceive(Receiver& receiver, const std::error_code& error, std::size_t bytes_transferred);
+#ifdef __linux__
+    void receiveBatches(Receiver& receiver);
+#endif
+    const std::string& sourceName(Receiver& receiver, uint32_t address, uint16_t port);
+    void openSocket(asio::ip::udp::socket& socket);
 
     int _port;
     DataCallback _onDataReceived;
+    UdpListenOptions _options;
+    uint32_t _sourceFilter = 0; // Host order, 0: any
+    size_t _receiverCount;
     
-    asio::io_context _ioContext;
-    std::unique_ptr<asio::ip::udp::socket> _socket;
-    asio::ip::udp::endpoint _remoteEndpoint;
-    std::vector<char> _recvBuffer;
+    PendingOps _ops;
+    std::vector<std::unique_ptr<Receiver>> _receivers;
     
-    std::thread _serviceThread;
     std::atomic<bool> _running{false};
 };
 
@@ -0,0 +1,399 @@
+#include "AisDecoder.hpp"
+#include "NmeaChecksum.hpp"
+#include "NmeaFields.hpp"
+#include "core/AisTargetStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Parsers {
+
+namespace {
+
+// Multipart messages older than this are considered lost
+constexpr auto FragmentTimeout = std::chrono::seconds(10);
+
+// Payload armoring: '0'-'W' and '`'-'w' carry 6 bits each
+int sixBitValue(char c) {
+    if (c >= '0' && c <= 'W') return c - '0';
+    if (c >= '`' && c <= 'w') return c - '0' - 8;
+    return -1;
+}
+
+template<size_t N>
+void copyText(std::array<char, N>& dest, const char* text) {
+    size_t length = std::min(std::strlen(text), N - 1);
+    std::memcpy(dest.data(), text, length);
+    dest[length] = '\0';
+}
+
+// Position in 1/10000 minute (or 1/10 minute for message 27), 181/91 degrees if not available
+bool toPosition(int32_t rawLon, int32_t rawLat, double scale, double& lon, double& lat) {
+    lon = rawLon / scale;
+    lat = rawLat / scale;
+    return std::fabs(lon) <= 180.0 && std::fabs(lat) <= 90.0;
+}
+
+} // namespace
+
+uint32_t AisBitReader::u(size_t start, size_t length) const {
+    if (length == 0 || start >= _bitCount) return 0;
+    if (start + length > _bitCount) {
+        // Missing trailing bits read as zero
+        size_t available = _bitCount - start;
+        return u(start, available) << (length - available);
+    }
+
+    // Gather the 8 bytes holding the field (at most 32 bits + 7 bits of offset)
+    size_t byteCount = (_bitCount + 7) / 8;
+    size_t first = start / 8;
+    uint64_t word = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        word = (word << 8) | (first + i < byteCount ? _bytes[first + i] : 0);
+    }
+    size_t offset = start % 8;
+    uint64_t mask = (uint64_t(1) << length) - 1;
+    return static_cast<uint32_t>((word >> (64 - offset - length)) & mask);
+}
+
+int32_t AisBitReader::s(size_t start, size_t length) const {
+    uint32_t value = u(start, length);
+    if (length < 32 && (value & (uint32_t(1) << (length - 1)))) {
+        value |= ~((uint32_t(1) << length) - 1); // Sign extension
+    }
+    return static_cast<int32_t>(value);
+}
+
+void AisBitReader::text(size_t start, size_t chars, char* out, size_t outSize) const {
+    if (outSize == 0) return;
+    size_t n = 0;
+    for (size_t i = 0; i < chars && n + 1 < outSize; ++i) {
+        uint32_t v = u(start + i * 6, 6);
+        char c = static_cast<char>(v < 32 ? v + 64 : v);
+        if (c == '@') break; // '@' pads the end of the string
+        out[n++] = c;
+    }
+    while (n > 0 && out[n - 1] == ' ') --n;
+    out[n] = '\0';
+}
+
+AisDecoder::Status AisDecoder::decode(std::string_view sentence, AisMessage* message) {
+    if (sentence.empty() || sentence[0] != '!' || !NmeaChecksum::verify(sentence)) {
+        count(_errors);
+        return Status::Error;
+    }
+
+    // !AIVDM,count,number,sequence,channel,payload,fill*hh
+    NmeaFields fields;
+    fields.tokenize(sentence.substr(1, sentence.find('*') - 1));
+
+    std::string_view header = fields[0];
+    if (header.size() < 3 || (header.substr(header.size() - 3) != "VDM" && header.substr(header.size() - 3) != "VDO")) {
+        count(_unsupported);
+        return Status::Unsupported;
+    }
+
+    int fragmentCount = 0;
+    int fragmentNumber = 0;
+    int fillBits = 0;
+    std::string_view payload = fields[5];
+    if (fields.size() < 7 || !toInt(fields[1], fragmentCount) || !toInt(fields[2], fragmentNumber) ||
+        fragmentCount < 1 || fragmentCount > 9 || fragmentNumber < 1 || fragmentNumber > fragmentCount ||
+        payload.empty() || payload.size() > MaxPayloadChars) {
+        count(_errors);
+        return Status::Error;
+    }
+    if (!fields[6].empty() && (!toInt(fields[6], fillBits) || fillBits < 0 || fillBits > 5)) {
+        count(_errors);
+        return Status::Error;
+    }
+
+    if (fragmentCount == 1) {
+        return decodePayload(payload.data(), payload.size(), fillBits, message);
+    }
+
+    // Multipart: reassemble in the (sequence ID, channel) slot
+    int sequenceId = 0;
+    if (!fields[3].empty() && (!toInt(fields[3], sequenceId) || sequenceId < 0 || sequenceId >= static_cast<int>(MaxSequenceIds))) {
+        count(_errors);
+        return Status::Error;
+    }
+    Fragments& slot = _fragments[sequenceId * ChannelCount + channelIndex(fields[4])];
+    auto now = std::chrono::steady_clock::now();
+
+    if (fragmentNumber == 1) {
+        if (slot.expectedCount != 0) count(_droppedFragments); // Previous message never completed
+        slot.expectedCount = fragmentCount;
+        slot.nextNumber = 1;
+        slot.length = 0;
+        slot.started = now;
+    } else if (slot.expectedCount != fragmentCount || slot.nextNumber != fragmentNumber ||
+               now - slot.started > FragmentTimeout) {
+        if (slot.expectedCount != 0) count(_droppedFragments);
+        slot.expectedCount = 0;
+        count(_errors);
+        return Status::Error;
+    }
+
+    if (slot.length + payload.size() > MaxPayloadChars) {
+        count(_droppedFragments);
+        slot.expectedCount = 0;
+        count(_errors);
+        return Status::Error;
+    }
+    std::memcpy(slot.payload.data() + slot.length, payload.data(), payload.size());
+    slot.length += payload.size();
+    slot.nextNumber++;
+
+    if (fragmentNumber < fragmentCount) return Status::Incomplete;
+
+    slot.expectedCount = 0;
+    return decodePayload(slot.payload.data(), slot.length, fillBits, message);
+}
+
+size_t AisDecoder::channelIndex(std::string_view channel) {
+    if (channel == "A" || channel == "1") return 0;
+    if (channel == "B" || channel == "2") return 1;
+    return 2;
+}
+
+uint32_t AisDecoder::peekMmsi(std::string_view payload) {
+    // Type (6 bits), repeat (2), MMSI (30): the first 7 characters
+    if (payload.size() < 7) return 0;
+    uint64_t bits = 0;
+    for (size_t i = 0; i < 7; ++i) {
+        int v = sixBitValue(payload[i]);
+        if (v < 0) return 0;
+        bits = (bits << 6) | static_cast<uint64_t>(v);
+    }
+    return static_cast<uint32_t>((bits >> 4) & 0x3FFFFFFF);
+}
+
+AisDecoder::Status AisDecoder::decodePayload(const char* payload, size_t length, int fillBits, AisMessage* message) {
+    // Unpack the 6-bit characters into bytes, MSB first
+    std::array<uint8_t, MaxPayloadChars * 6 / 8 + 1> bytes{};
+    size_t byteCount = 0;
+    uint32_t acc = 0;
+    int accBits = 0;
+    for (size_t i = 0; i < length; ++i) {
+        int v = sixBitValue(payload[i]);
+        if (v < 0) {
+            count(_errors);
+            return Status::Error;
+        }
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        accBits += 6;
+        if (accBits >= 8) {
+            accBits -= 8;
+            bytes[byteCount++] = static_cast<uint8_t>(acc >> accBits);
+            acc &= (1u << accBits) - 1;
+        }
+    }
+    if (accBits > 0) bytes[byteCount++] = static_cast<uint8_t>(acc << (8 - accBits));
+
+    size_t bitCount = length * 6;
+    bitCount = bitCount > static_cast<size_t>(fillBits) ? bitCount - fillBits : 0;
+    AisBitReader bits(bytes.data(), bitCount);
+
+    auto malformed = [this]() {
+        count(_errors);
+        return Status::Error;
+    };
+    if (bits.size() < 38) return malformed();
+
+    int type = static_cast<int>(bits.u(0, 6));
+    uint32_t mmsi = bits.u(8, 30);
+    if (mmsi == 0) return malformed();
+
+    AisMessage decoded;
+    decoded.type = type;
+    decoded.mmsi = mmsi;
+
+    auto& store = Core::AisTargetStore::instance();
+    auto now = std::chrono::system_clock::now();
+    char text[40];
+
+    switch (type) {
+        case 1:
+        case 2:
+        case 3: {
+            // Class A position report
+            if (bits.size() < 137) return malformed();
+            decoded.hasPosition = toPosition(bits.s(61, 28), bits.s(89, 27), 600000.0, decoded.longitude, decoded.latitude);
+            uint32_t sog = bits.u(50, 10);
+            uint32_t cog = bits.u(116, 12);
+            uint32_t heading = bits.u(128, 9);
+            int status = static_cast<int>(bits.u(38, 4));
+            store.update(mmsi, [&](Core::AisTarget& t) {
+                t.lastMessageType = static_cast<uint8_t>(type);
+                t.isClassB = false;
+                t.navigationStatus = status;
+                t.speedOverGround = sog == 1023 ? -1.0 : sog / 10.0;
+                t.courseOverGround = cog >= 3600 ? -1.0 : cog / 10.0;
+                t.heading = heading == 511 ? -1 : static_cast<int>(heading);
+                if (decoded.hasPosition) {
+                    t.hasPosition = true;
+                    t.latitude = decoded.latitude;
+                    t.longitude = decoded.longitude;
+                }
+                t.lastUpdate = now;
+            });
+            break;
+        }
+        case 18:
+        case 19: {
+            // Class B position report (19: extended, with static data)
+            if (bits.size() < 133 || (type == 19 && bits.size() < 301)) return malformed();
+            decoded.hasPosition = toPosition(bits.s(57, 28), bits.s(85, 27), 600000.0, decoded.longitude, decoded.latitude);
+            uint32_t sog = bits.u(46, 10);
+            uint32_t cog = bits.u(112, 12);
+            uint32_t heading = bits.u(124, 9);
+            if (type == 19) bits.text(143, 20, text, sizeof(text));
+            store.update(mmsi, [&](Core::AisTarget& t) {
+                t.lastMessageType = static_cast<uint8_t>(type);
+                t.isClassB = true;
+                t.speedOverGround = sog == 1023 ? -1.0 : sog / 10.0;
+                t.courseOverGround = cog >= 3600 ? -1.0 : cog / 10.0;
+                t.heading = heading == 511 ? -1 : static_cast<int>(heading);
+                if (decoded.hasPosition) {
+                    t.hasPosition = true;
+                    t.latitude = decoded.latitude;
+                    t.longitude = decoded.longitude;
+                }
+                if (type == 19) {
+                    t.hasStatic = true;
+                    copyText(t.name, text);
+                    t.shipType = static_cast<uint8_t>(bits.u(263, 8));
+                    t.toBow = static_cast<uint16_t>(bits.u(271, 9));
+                    t.toStern = static_cast<uint16_t>(bits.u(280, 9));
+                    t.toPort = static_cast<uint8_t>(bits.u(289, 6));
+                    t.toStarboard = static_cast<uint8_t>(bits.u(295, 6));
+                }
+                t.lastUpdate = now;
+            });
+            break;
+        }
+        case 27: {
+            // Long range broadcast (position in 1/10 minute)
+            if (bits.size() < 95) return malformed();
+            decoded.hasPosition = toPosition(bits.s(44, 18), bits.s(62, 17), 600.0, decoded.longitude, decoded.latitude);
+            uint32_t sog = bits.u(79, 6);
+            uint32_t cog = bits.u(85, 9);
+            int status = static_cast<int>(bits.u(40, 4));
+            store.update(mmsi, [&](Core::AisTarget& t) {
+                t.lastMessageType = static_cast<uint8_t>(type);
+                t.navigationStatus = status;
+                t.speedOverGround = sog == 63 ? -1.0 : static_cast<double>(sog);
+                t.courseOverGround = cog >= 360 ? -1.0 : static_cast<double>(cog);
+                if (decoded.hasPosition) {
+                    t.hasPosition = true;
+                    t.latitude = decoded.latitude;
+                    t.longitude = decoded.longitude;
+                }
+                t.lastUpdate = now;
+            });
+            break;
+        }
+        case 5: {
+            // Class A static and voyage data
+            if (bits.size() < 302) return malformed();
+            char callsign[8];
+            char destination[21];
+            bits.text(70, 7, callsign, sizeof(callsign));
+            bits.text(112, 20, text, sizeof(text));
+            bits.text(302, 20, destination, sizeof(destination));
+            store.update(mmsi, [&](Core::AisTarget& t) {
+                t.lastMessageType = static_cast<uint8_t>(type);
+                t.isClassB = false;
+                t.hasStatic = true;
+                t.imo = bits.u(40, 30);
+                copyText(t.callsign, callsign);
+                copyText(t.name, text);
+                t.shipType = static_cast<uint8_t>(bits.u(232, 8));
+                t.toBow = static_cast<uint16_t>(bits.u(240, 9));
+                t.toStern = static_cast<uint16_t>(bits.u(249, 9));
+                t.toPort = static_cast<uint8_t>(bits.u(258, 6));
+                t.toStarboard = static_cast<uint8_t>(bits.u(264, 6));
+                t.draught = bits.u(294, 8) / 10.0;
+                copyText(t.destination, destination);
+                t.lastUpdate = now;
+            });
+            break;
+        }
+        case 24: {
+            // Class B static data, in two independent parts
+            if (bits.size() < 160) return malformed();
+            uint32_t part = bits.u(38, 2);
+            if (part > 1) return malformed();
+            char callsign[8];
+            if (part == 0) {
+                bits.text(40, 20, text, sizeof(text));
+            } else {
+                bits.text(90, 7, callsign, sizeof(callsign));
+            }
+            store.update(mmsi, [&](Core::AisTarget& t) {
+                t.lastMessageType = static_cast<uint8_t>(type);
+                t.isClassB = true;
+                t.hasStatic = true;
+                if (part == 0) {
+                    copyText(t.name, text);
+                } else {
+                    t.shipType = static_cast<uint8_t>(bits.u(40, 8));
+                    copyText(t.callsign, callsign);
+                    t.toBow = static_cast<uint16_t>(bits.u(132, 9));
+                    t.toStern = static_cast<uint16_t>(bits.u(141, 9));
+                    t.toPort = static_cast<uint8_t>(bits.u(150, 6));
+                    t.toStarboard = static_cast<uint8_t>(bits.u(156, 6));
+                }
+                t.lastUpdate = now;
+            });
+            break;
+        }
+        case 21: {
+            // Aid to navigation: name of 20 chars, extended by up to 14 chars after bit 272
+            if (bits.size() < 272) return malformed();
+            bits.text(43, 20, text, sizeof(text));
+            size_t extensionChars = (bits.size() - 272) / 6;
+            if (extensionChars > 0 && std::strlen(text) == 20) {
+                bits.text(272, extensionChars > 14 ? 14 : extensionChars, text + 20, sizeof(text) - 20);
+            }
+            decoded.hasPosition = toPosition(bits.s(164, 28), bits.s(192, 27), 600000.0, decoded.longitude, decoded.latitude);
+            store.update(mmsi, [&](Core::AisTarget& t) {
+                t.lastMessageType = static_cast<uint8_t>(type);
+                t.isAidToNavigation = true;
+                t.hasStatic = true;
+                t.aidType = static_cast<uint8_t>(bits.u(38, 5));
+                copyText(t.name, text);
+                t.toBow = static_cast<uint16_t>(bits.u(219, 9));
+                t.toStern = static_cast<uint16_t>(bits.u(228, 9));
+                t.toPort = static_cast<uint8_t>(bits.u(237, 6));
+                t.toStarboard = static_cast<uint8_t>(bits.u(243, 6));
+                if (decoded.hasPosition) {
+                    t.hasPosition = true;
+                    t.latitude = decoded.latitude;
+                    t.longitude = decoded.longitude;
+                }
+                t.lastUpdate = now;
+            });
+            break;
+        }
+        default:
+            count(_unsupported);
+            return Status::Unsupported;
+    }
+
+    count(_decoded);
+    if (message) *message = decoded;
+    return Status::Decoded;
+}
+
+AisDecoder::Stats AisDecoder::getStats() const {
+    Stats stats;
+    stats.decoded = _decoded.load(std::memory_order_relaxed);
+    stats.unsupported = _unsupported.load(std::memory_order_relaxed);
+    stats.errors = _errors.load(std::memory_order_relaxed);
+    stats.droppedFragments = _droppedFragments.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace Parsers
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Parsers {
+
+// Read-only cursor over a 6-bit unpacked AIS payload, packed MSB first into bytes.
+// Reads past the end return zero bits, so short (older) messages decode as "not available".
+class AisBitReader {
+public:
+    AisBitReader(const uint8_t* bytes, size_t bitCount) : _bytes(bytes), _bitCount(bitCount) {}
+
+    size_t size() const { return _bitCount; }
+
+    uint32_t u(size_t start, size_t length) const;
+    int32_t s(size_t start, size_t length) const;
+
+    // Decodes 'chars' 6-bit characters into 'out' (NUL terminated), trimming '@' and spaces
+    void text(size_t start, size_t chars, char* out, size_t outSize) const;
+
+private:
+    const uint8_t* _bytes;
+    size_t _bitCount;
+};
+
+// Summary of the last message decoded, for callers that route or filter on it
+struct AisMessage {
+    int type = 0;
+    uint32_t mmsi = 0;
+    bool hasPosition = false;
+    double latitude = 0.0;
+    double longitude = 0.0;
+};
+
+// Decodes !AIVDM/!AIVDO sentences (types 1/2/3/5/18/19/21/24/27) into Core::AisTargetStore.
+// Holds the multipart reassembly state of one source: use one decoder per source,
+// fed from a single thread.
+class AisDecoder {
+public:
+    enum class Status { Decoded, Incomplete, Unsupported, Error };
+
+    struct Stats {
+        uint64_t decoded = 0;
+        uint64_t unsupported = 0;
+        uint64_t errors = 0;          // Malformed sentences or payloads
+        uint64_t droppedFragments = 0; // Multipart messages lost (missing or out of order fragments)
+    };
+
+    static constexpr size_t MaxPayloadChars = 256; // Up to 1536 bits, type 5 needs 71 chars
+    static constexpr size_t MaxSequenceIds = 10;   // Sequential message IDs are 0-9
+    static constexpr size_t ChannelCount = 3;      // A, B, other/none
+
+    // 'message' (optional) receives a summary of a decoded message
+    Status decode(std::string_view sentence, AisMessage* message = nullptr);
+
+    // MMSI at the start of a (first fragment) payload, 0 if too short or malformed
+    static uint32_t peekMmsi(std::string_view payload);
+
+    // Channel field ("A", "B", "1", "2", other) to an index below ChannelCount
+    static size_t channelIndex(std::string_view channel);
+
+    Stats getStats() const;
+
+private:
+    struct Fragments {
+        int expectedCount = 0; // 0: slot free
+        int nextNumber = 0;
+        size_t length = 0;
+        std::chrono::steady_clock::time_point started;
+        std::array<char, MaxPayloadChars> payload;
+    };
+
+    Status decodePayload(const char* payload, size_t length, int fillBits, AisMessage* message);
+    void count(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Bounded reassembly table indexed by (sequence ID, channel)
+    std::array<Fragments, MaxSequenceIds * ChannelCount> _fragments{};
+
+    std::atomic<uint64_t> _decoded{0};
+    std::atomic<uint64_t> _unsupported{0};
+    std::atomic<uint64_t> _errors{0};
+    std::atomic<uint64_t> _droppedFragments{0};
+};
+
+} // namespace Parsers
@@ -0,0 +1,226 @@
+#include "NmeaChecksum.hpp"
+#include <cstring>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define NMEA_SIMD_X86 1
+    #define NMEA_SIMD_AVX2_TARGET __attribute__((target("avx2")))
+    #include <immintrin.h>
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NMEA_SIMD_X86 1
+    #define NMEA_SIMD_AVX2_TARGET
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
+
+namespace Parsers {
+
+namespace {
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// --- Scalar fallback (8 bytes per step) ---
+
+uint8_t xorScalar(const char* p, size_t n) {
+    uint64_t acc = 0;
+    while (n >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        acc ^= word;
+        p += 8;
+        n -= 8;
+    }
+    acc ^= acc >> 32;
+    acc ^= acc >> 16;
+    acc ^= acc >> 8;
+    uint8_t result = static_cast<uint8_t>(acc);
+    while (n--) result ^= static_cast<uint8_t>(*p++);
+    return result;
+}
+
+const char* findNewlineScalar(const char* p, const char* end) {
+    const void* hit = std::memchr(p, '\n', end - p);
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+#ifdef NMEA_SIMD_X86
+
+unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+uint8_t foldSse2(__m128i acc) {
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+    return static_cast<uint8_t>(_mm_cvtsi128_si32(acc));
+}
+
+// --- SSE2 (16 bytes per step, baseline on x86-64) ---
+
+uint8_t xorSse2(const char* p, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    while (n >= 16) {
+        acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        p += 16;
+        n -= 16;
+    }
+    return foldSse2(acc) ^ xorScalar(p, n);
+}
+
+const char* findNewlineSse2(const char* p, const char* end) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        if (mask) return p + lowestBit(mask);
+        p += 16;
+    }
+    return findNewlineScalar(p, end);
+}
+
+// --- AVX2 (32 bytes per step, selected at runtime) ---
+
+NMEA_SIMD_AVX2_TARGET uint8_t xorAvx2(const char* p, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    while (n >= 32) {
+        acc = _mm256_xor_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        p += 32;
+        n -= 32;
+    }
+    // Tail and fold stay in this function so that everything is VEX encoded
+    // (mixing in legacy SSE code would pay AVX/SSE transition penalties)
+    __m128i half = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    if (n >= 16) {
+        half = _mm_xor_si128(half, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        p += 16;
+        n -= 16;
+    }
+    half = _mm_xor_si128(half, _mm_srli_si128(half, 8));
+    half = _mm_xor_si128(half, _mm_srli_si128(half, 4));
+    half = _mm_xor_si128(half, _mm_srli_si128(half, 2));
+    half = _mm_xor_si128(half, _mm_srli_si128(half, 1));
+    uint8_t result = static_cast<uint8_t>(_mm_cvtsi128_si32(half));
+    while (n--) result ^= static_cast<uint8_t>(*p++);
+    return result;
+}
+
+NMEA_SIMD_AVX2_TARGET const char* findNewlineAvx2(const char* p, const char* end) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+        if (mask) return p + lowestBit(mask);
+        p += 32;
+    }
+    while (p < end && *p != '\n') ++p;
+    return p;
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    #ifdef __AVX2__
+    return true;
+    #else
+    return false; // Build with /arch:AVX2 to enable the AVX2 path
+    #endif
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // NMEA_SIMD_X86
+
+struct Kernels {
+    uint8_t (*xorBytes)(const char*, size_t);
+    const char* (*findNewline)(const char*, const char*);
+    const char* name;
+};
+
+Kernels selectKernels() {
+#ifdef NMEA_SIMD_X86
+    if (cpuHasAvx2()) return { &xorAvx2, &findNewlineAvx2, "AVX2" };
+    return { &xorSse2, &findNewlineSse2, "SSE2" };
+#else
+    return { &xorScalar, &findNewlineScalar, "Scalar" };
+#endif
+}
+
+const Kernels& kernels() {
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+// 'line' has no CR/LF. Valid if it looks like "$...*hh" or "!...*hh".
+bool checkLine(const char* line, size_t len, const Kernels& k) {
+    if (len < 4 || (line[0] != '$' && line[0] != '!') || line[len - 3] != '*') return false;
+
+    int high = hexValue(line[len - 2]);
+    int low = hexValue(line[len - 1]);
+    if (high < 0 || low < 0) return false;
+
+    return k.xorBytes(line + 1, len - 4) == ((high << 4) | low);
+}
+
+} // namespace
+
+uint8_t NmeaChecksum::compute(const char* data, size_t size) {
+    return kernels().xorBytes(data, size);
+}
+
+bool NmeaChecksum::verify(std::string_view sentence) {
+    while (!sentence.empty() && (sentence.back() == '\n' || sentence.back() == '\r')) {
+        sentence.remove_suffix(1);
+    }
+    return checkLine(sentence.data(), sentence.size(), kernels());
+}
+
+size_t NmeaChecksum::validateBatch(std::string_view buffer, std::vector<SentenceRecord>& out) {
+    const Kernels& k = kernels();
+    const char* base = buffer.data();
+    const char* end = base + buffer.size();
+    const char* p = base;
+    size_t added = 0;
+
+    while (p < end) {
+        const char* newline = k.findNewline(p, end);
+        const char* lineEnd = newline;
+        while (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+
+        size_t len = static_cast<size_t>(lineEnd - p);
+        if (len > 0) {
+            SentenceRecord record;
+            record.offset = static_cast<uint32_t>(p - base);
+            if (len > std::numeric_limits<uint16_t>::max()) {
+                // Far beyond any NMEA sentence: garbage
+                record.length = std::numeric_limits<uint16_t>::max();
+                record.valid = false;
+            } else {
+                record.length = static_cast<uint16_t>(len);
+                record.valid = checkLine(p, len, k);
+            }
+            out.push_back(record);
+            added++;
+        }
+        p = newline + 1;
+    }
+    return added;
+}
+
+const char* NmeaChecksum::implementation() {
+    return kernels().name;
+}
+
+} // namespace Parsers
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Parsers {
+
+// One sentence found in a batch buffer. Offset and length exclude the CR/LF terminator.
+struct SentenceRecord {
+    uint32_t offset;
+    uint16_t length;
+    bool valid; // Starts with '$' or '!' and carries a matching "*hh" checksum
+};
+
+class NmeaChecksum {
+public:
+    // XOR of all bytes, vectorized with AVX2 or SSE2 when available.
+    static uint8_t compute(const char* data, size_t size);
+
+    // Checks the "*hh" suffix of a single sentence (with or without CR/LF).
+    static bool verify(std::string_view sentence);
+
+    // Splits a buffer of CR/LF delimited sentences (e.g. a UDP burst or a chunk of
+    // a log file, smaller than 4 GiB) and validates them in one pass.
+    // Records are appended to 'out'. Empty lines are skipped. Returns the number of records added.
+    static size_t validateBatch(std::string_view buffer, std::vector<SentenceRecord>& out);
+
+    // Name of the code path selected for this CPU ("AVX2", "SSE2" or "Scalar")
+    static const char* implementation();
+};
+
+} // namespace Parsers
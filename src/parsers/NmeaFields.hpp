@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+namespace Parsers {
+
+// Comma separated fields of one NMEA sentence, as views into the original buffer.
+// Field 0 is the address field (e.g. "GPRMC"). Nothing is copied or allocated.
+struct NmeaFields {
+    static constexpr size_t MaxFields = 64;
+
+    std::array<std::string_view, MaxFields> items{};
+    size_t count = 0;
+
+    // Splits the sentence body (between '$'/'!' and '*') on ','.
+    // Fields beyond MaxFields are ignored.
+    void tokenize(std::string_view body) {
+        count = 0;
+        if (body.empty()) return;
+
+        size_t start = 0;
+        while (count < MaxFields) {
+            size_t comma = body.find(',', start);
+            if (comma == std::string_view::npos) {
+                items[count++] = body.substr(start);
+                break;
+            }
+            items[count++] = body.substr(start, comma - start);
+            start = comma + 1;
+        }
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Out of range fields read as empty, like a missing NMEA field.
+    std::string_view operator[](size_t i) const {
+        return i < count ? items[i] : std::string_view{};
+    }
+};
+
+// Numeric conversions without exceptions or allocations.
+// Like std::stod/std::stoi, a valid numeric prefix is accepted ("12.5M" -> 12.5).
+inline bool toDouble(std::string_view s, double& out) {
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    if (s.empty()) return false;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc{};
+}
+
+inline bool toInt(std::string_view s, int& out) {
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    if (s.empty()) return false;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc{};
+}
+
+} // namespace Parsers
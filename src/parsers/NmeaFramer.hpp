@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Parsers {
+
+// Cuts a byte stream (e.g. successive serial reads) into '$' and '!' sentences,
+// whatever the read boundaries. One framer per source, fed from a single thread.
+//
+// Sentences that lie entirely inside a chunk are emitted as views into that chunk.
+// Only the unterminated tail of a chunk is kept, in a carry buffer allocated once
+// at construction, and joined with the next chunk.
+class NmeaFramer {
+public:
+    static constexpr size_t DefaultMaxLineLength = 256; // NMEA allows 82, leave room for proprietary sentences
+
+    struct Stats {
+        uint64_t sentences = 0;
+        uint64_t overflows = 0; // Lines longer than the maximum, discarded
+        uint64_t resyncs = 0;   // Garbage skipped or sentences cut by a new start character
+    };
+
+    explicit NmeaFramer(size_t maxLineLength = DefaultMaxLineLength)
+        : _carry(maxLineLength), _maxLineLength(maxLineLength) {}
+
+    // Calls onSentence(std::string_view) for each complete sentence, without its CR/LF.
+    // The view is only valid during the call.
+    template<class F>
+    void feed(std::string_view chunk, F&& onSentence);
+
+    // Drops any partial sentence (e.g. after a port reopen)
+    void reset() {
+        _inSentence = false;
+        _discarding = false;
+        _inGarbage = false;
+        _carryLength = 0;
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.sentences = _sentences.load(std::memory_order_relaxed);
+        stats.overflows = _overflows.load(std::memory_order_relaxed);
+        stats.resyncs = _resyncs.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    static bool isStart(char c) { return c == '$' || c == '!'; }
+    static bool isEnd(char c) { return c == '\r' || c == '\n'; }
+
+    void count(std::atomic<uint64_t>& counter) {
+        // Single writer: a plain load/store is enough and avoids a locked instruction
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::vector<char> _carry;
+    size_t _carryLength = 0;
+    size_t _maxLineLength;
+
+    bool _inSentence = false; // Between a start character and its terminator
+    bool _discarding = false; // Skipping the rest of an overflowed line
+    bool _inGarbage = false;  // Skipping bytes outside any sentence
+
+    std::atomic<uint64_t> _sentences{0};
+    std::atomic<uint64_t> _overflows{0};
+    std::atomic<uint64_t> _resyncs{0};
+};
+
+template<class F>
+void NmeaFramer::feed(std::string_view chunk, F&& onSentence) {
+    const size_t size = chunk.size();
+    size_t i = 0;
+
+    while (i < size) {
+        if (!_inSentence) {
+            // Look for the next start character. A run of garbage counts as one resync,
+            // even when it spans several chunks.
+            while (i < size && !isStart(chunk[i])) {
+                char c = chunk[i];
+                if (isEnd(c)) {
+                    _discarding = false;
+                } else if (c != ' ' && c != '\0' && !_discarding && !_inGarbage) {
+                    _inGarbage = true;
+                    count(_resyncs);
+                }
+                ++i;
+            }
+            if (i == size) return;
+
+            _discarding = false;
+            _inGarbage = false;
+            _inSentence = true;
+            _carryLength = 0;
+        }
+
+        // Inside a sentence: chunk[segmentStart..] continues what is in the carry buffer
+        size_t segmentStart = i;
+        if (_carryLength == 0) ++i; // Skip our own start character
+        while (i < size && !isEnd(chunk[i]) && !isStart(chunk[i])) ++i;
+
+        size_t segmentLength = i - segmentStart;
+        if (_carryLength + segmentLength > _maxLineLength) {
+            count(_overflows);
+            _inSentence = false;
+            _discarding = true;
+            _carryLength = 0;
+            continue;
+        }
+
+        if (i == size) {
+            // Unterminated: keep it for the next chunk
+            std::copy(chunk.begin() + segmentStart, chunk.end(), _carry.begin() + _carryLength);
+            _carryLength += segmentLength;
+            return;
+        }
+
+        if (isStart(chunk[i])) {
+            // A new sentence began before this one was terminated
+            count(_resyncs);
+            _inSentence = false;
+            _carryLength = 0;
+            continue;
+        }
+
+        // Terminated
+        std::string_view sentence;
+        if (_carryLength == 0) {
+            sentence = chunk.substr(segmentStart, segmentLength);
+        } else {
+            std::copy(chunk.begin() + segmentStart, chunk.begin() + i, _carry.begin() + _carryLength);
+            _carryLength += segmentLength;
+            sentence = std::string_view(_carry.data(), _carryLength);
+        }
+
+        _inSentence = false;
+        _carryLength = 0;
+        ++i;
+
+        if (sentence.size() > 1) {
+            count(_sentences);
+            onSentence(sentence);
+        }
+    }
+}
+
+} // namespace Parsers
@@ -1,9 +1,10 @@
 #include "NmeaParser.hpp"
-#include <sstream>
-#include <iomanip>
-#include <iostream>
-#include <algorithm>
+#include "NmeaChecksum.hpp"
+#include <array>
+#include <atomic>
 #include <ctime>
+#include <mutex>
+#include <thread>
 
 #ifdef _WIN32
     #define timegm _mkgmtime
@@ -11,101 +12,232 @@
 
 namespace Parsers {
 
-bool NmeaParser::parse(const std::string& sentence, Core::NavData& data) {
-    if (sentence.empty() || sentence[0] != '$') return false;
+// Handlers indexed by the three formatter letters packed into 15 bits.
+// The 32K entry index holds 1-based slot numbers, so a lookup is one byte load
+// and the slots (and their counters) stay small and cache friendly.
+class NmeaParser::SentenceTable {
+public:
+    static constexpr size_t MaxSlots = 255;
 
-    // Checksum validation
-    if (!verifyChecksum(sentence)) {
-        return false;
+    SentenceTable() {
+        for (auto& entry : _index) entry.store(0, std::memory_order_relaxed);
+        add("RMC", &NmeaParser::parseRMC, true);
+        add("GGA", &NmeaParser::parseGGA, true);
+        add("MWV", &NmeaParser::parseMWV, true);
+        add("DPT", &NmeaParser::parseDPT, true);
+        add("MTW", &NmeaParser::parseMTW, true);
+        add("VHW", &NmeaParser::parseVHW, true);
+        add("HDT", &NmeaParser::parseHDT, true);
     }
 
-    // Extract content between '$' and '*'
-    size_t starPos = sentence.find('*');
-    std::string cleanSentence = sentence.substr(1, starPos - 1);
-    
-    auto tokens = split(cleanSentence, ',');
-    if (tokens.empty()) return false;
+    // Returns -1 if the formatter is not three uppercase letters
+    static int pack(std::string_view formatter) {
+        if (formatter.size() != 3) return -1;
+        int key = 0;
+        for (char c : formatter) {
+            if (c < 'A' || c > 'Z') return -1;
+            key = (key << 5) | (c - 'A');
+        }
+        return key;
+    }
 
-    // Get Talker ID and Sentence Type (e.g., "GPRMC" -> "RMC")
-    std::string header = tokens[0];
-    if (header.length() < 3) return false;
-    
-    std::string type = header.substr(header.length() - 3);
+    bool dispatch(std::string_view formatter, const NmeaFields& tokens, Core::NavData& data, bool countStats) {
+        int key = pack(formatter);
+        uint8_t slotIdx = key < 0 ? 0 : _index[key].load(std::memory_order_acquire);
+        if (slotIdx == 0) {
+            if (countStats) _unhandled.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
 
-    try {
-        if (type == "RMC") {
-            parseRMC(tokens, data);
-            return true;
-        } else if (type == "GGA") {
-            parseGGA(tokens, data);
-            return true;
-        } else if (type == "MWV") {
-            parseMWV(tokens, data);
-            return true;
-        } else if (type == "DPT") {
-            parseDPT(tokens, data);
-            return true;
-        } else if (type == "MTW") {
-            parseMTW(tokens, data);
-            return true;
-        } else if (type == "VHW") {
-            parseVHW(tokens, data);
-            return true;
-        } else if (type == "HDT") {
-            parseHDT(tokens, data);
+        Slot& slot = _slots[slotIdx - 1];
+        SentenceHandler handler = slot.handler.load(std::memory_order_acquire);
+
+        // Plugin code is counted while it runs, so that remove() can wait for it before the
+        // library is unloaded. Built-in handlers never go away: no shared counter for them.
+        InUse inUse;
+        if (handler && handler != slot.builtin) {
+            inUse.enter(slot);
+            handler = slot.handler.load(std::memory_order_seq_cst);
+        }
+        if (!handler) {
+            if (countStats) _unhandled.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (countStats) slot.hits.fetch_add(1, std::memory_order_relaxed);
+        if (!handler(tokens, data)) {
+            if (countStats) slot.failures.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    // 'builtin': handler restored by remove(), set by the constructor only
+    bool add(std::string_view formatter, SentenceHandler handler, bool builtin = false) {
+        int key = pack(formatter);
+        if (key < 0) return false;
+
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        uint8_t slotIdx = _index[key].load(std::memory_order_relaxed);
+        if (slotIdx != 0) {
+            _slots[slotIdx - 1].handler.store(handler, std::memory_order_release);
             return true;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Parse Error: " << e.what() << std::endl;
-        return false;
+
+        if (_slotCount == MaxSlots) return false;
+        Slot& slot = _slots[_slotCount];
+        formatter.copy(slot.formatter, 3);
+        if (builtin) slot.builtin = handler;
+        slot.handler.store(handler, std::memory_order_relaxed);
+        _slotCount++;
+        // Publish the slot only once it is fully initialized
+        _index[key].store(static_cast<uint8_t>(_slotCount), std::memory_order_release);
+        return true;
     }
 
-    return false;
-}
+    void remove(std::string_view formatter) {
+        int key = pack(formatter);
+        if (key < 0) return;
 
-std::vector<std::string> NmeaParser::split(const std::string& s, char delimiter) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream tokenStream(s);
-    while (std::getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
+        // The slot is kept so that its counters and index entry stay valid.
+        // A built-in handler overridden by a plugin takes its place back.
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        uint8_t slotIdx = _index[key].load(std::memory_order_relaxed);
+        if (slotIdx == 0) return;
+        Slot& slot = _slots[slotIdx - 1];
+        slot.handler.store(slot.builtin, std::memory_order_seq_cst);
+
+        // Dispatches that loaded the previous handler may still run it
+        while (slot.inUse.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+    }
+
+    std::vector<SentenceStats> stats() {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        std::vector<SentenceStats> result;
+        result.reserve(_slotCount);
+        for (size_t i = 0; i < _slotCount; ++i) {
+            const Slot& slot = _slots[i];
+            SentenceStats entry;
+            entry.formatter.assign(slot.formatter, 3);
+            entry.hits = slot.hits.load(std::memory_order_relaxed);
+            entry.failures = slot.failures.load(std::memory_order_relaxed);
+            result.push_back(entry);
+        }
+        return result;
     }
-    // Handle case where last token is empty (e.g., "data,")
-    if (!s.empty() && s.back() == delimiter) {
-        tokens.push_back("");
+
+    uint64_t unhandled() const { return _unhandled.load(std::memory_order_relaxed); }
+
+    void resetStats() {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        for (size_t i = 0; i < _slotCount; ++i) {
+            _slots[i].hits.store(0, std::memory_order_relaxed);
+            _slots[i].failures.store(0, std::memory_order_relaxed);
+        }
+        _unhandled.store(0, std::memory_order_relaxed);
     }
-    return tokens;
+
+private:
+    // One cache line per formatter so that counters of different sentences
+    // updated by different I/O threads do not false-share.
+    struct alignas(64) Slot {
+        std::atomic<SentenceHandler> handler{nullptr};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint32_t> inUse{0}; // Dispatches running a plugin handler
+        SentenceHandler builtin = nullptr;
+        char formatter[3] = {};
+    };
+
+    // Pairs with remove(): either the dispatch sees the new handler, or remove() sees it running
+    class InUse {
+    public:
+        void enter(Slot& slot) {
+            _slot = &slot;
+            slot.inUse.fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~InUse() {
+            if (_slot) _slot->inUse.fetch_sub(1, std::memory_order_release);
+        }
+
+    private:
+        Slot* _slot = nullptr;
+    };
+
+    std::array<std::atomic<uint8_t>, 1 << 15> _index;
+    std::array<Slot, MaxSlots> _slots;
+    size_t _slotCount = 0;
+    std::atomic<uint64_t> _unhandled{0};
+    std::mutex _writeMutex;
+};
+
+NmeaParser::SentenceTable& NmeaParser::table() {
+    static SentenceTable instance;
+    return instance;
 }
 
-bool NmeaParser::verifyChecksum(const std::string& sentence) {
-    size_t starPos = sentence.find('*');
-    if (starPos == std::string::npos || starPos + 3 > sentence.length()) return false;
+bool NmeaParser::registerHandler(std::string_view formatter, SentenceHandler handler) {
+    if (!handler) return false;
+    return table().add(formatter, handler);
+}
+
+void NmeaParser::unregisterHandler(std::string_view formatter) {
+    table().remove(formatter);
+}
+
+std::vector<NmeaParser::SentenceStats> NmeaParser::getSentenceStats() {
+    return table().stats();
+}
 
-    unsigned char calculated = 0;
-    for (size_t i = 1; i < starPos; ++i) {
-        calculated ^= sentence[i];
+uint64_t NmeaParser::getUnhandledCount() {
+    return table().unhandled();
+}
+
+void NmeaParser::resetStats() {
+    table().resetStats();
+}
+
+bool NmeaParser::parse(std::string_view sentence, Core::NavData& data, bool countStats) {
+    if (sentence.empty() || sentence[0] != '$') return false;
+
+    // Checksum validation
+    if (!NmeaChecksum::verify(sentence)) {
+        return false;
     }
 
-    std::string checksumStr = sentence.substr(starPos + 1, 2);
-    unsigned int provided;
-    std::stringstream ss;
-    ss << std::hex << checksumStr;
-    ss >> provided;
+    // Fields between '$' and '*', sliced in place
+    size_t starPos = sentence.find('*');
+    NmeaFields tokens;
+    tokens.tokenize(sentence.substr(1, starPos - 1));
+    if (tokens.empty()) return false;
+
+    // Get Talker ID and Sentence Type (e.g., "GPRMC" -> "RMC")
+    std::string_view header = tokens[0];
+    if (header.length() < 3) return false;
+
+    return table().dispatch(header.substr(header.length() - 3), tokens, data, countStats);
+}
 
-    return calculated == provided;
+bool NmeaParser::verifyChecksum(std::string_view sentence) {
+    return NmeaChecksum::verify(sentence);
 }
 
-double convertNmeaCoord(const std::string& val, const std::string& dir) {
-    if (val.empty()) return 0.0;
-    double raw = std::stod(val);
+static bool convertNmeaCoord(std::string_view val, std::string_view dir, double& out) {
+    if (val.empty()) {
+        out = 0.0;
+        return true;
+    }
+    double raw;
+    if (!toDouble(val, raw)) return false;
     int degrees = static_cast<int>(raw / 100);
     double minutes = raw - (degrees * 100);
     double decimal = degrees + (minutes / 60.0);
     if (dir == "S" || dir == "W") decimal = -decimal;
-    return decimal;
+    out = decimal;
+    return true;
 }
 
-void NmeaParser::parseRMC(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseRMC(const NmeaFields& tokens, Core::NavData& data) {
     // $GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A
     // 0: ID
     // 1: Time (HHMMSS)
@@ -118,7 +250,7 @@ void NmeaParser::parseRMC(const std::vector<std::string>& tokens, Core::NavData&
     // 8: Track angle (True)
     // 9: Date (DDMMYY)
     
-    if (tokens.size() < 10) return;
+    if (tokens.size() < 10) return true;
 
     // Parse regardless of status (A or V) to allow debugging / partial data
     // if (tokens[2] == "A") {
@@ -129,48 +261,47 @@ void NmeaParser::parseRMC(const std::vector<std::string>& tokens, Core::NavData&
 
         // Position
         if (!tokens[3].empty() && !tokens[4].empty()) {
-            data.latitude = convertNmeaCoord(tokens[3], tokens[4]);
+            if (!convertNmeaCoord(tokens[3], tokens[4], data.latitude)) return false;
         }
         if (!tokens[5].empty() && !tokens[6].empty()) {
-            data.longitude = convertNmeaCoord(tokens[5], tokens[6]);
+            if (!convertNmeaCoord(tokens[5], tokens[6], data.longitude)) return false;
         }
 
         // Speed
-        if (!tokens[7].empty()) data.speedOverGround = std::stod(tokens[7]);
+        if (!tokens[7].empty() && !toDouble(tokens[7], data.speedOverGround)) return false;
         
         // Course / Heading
         if (!tokens[8].empty()) {
-            data.courseOverGround = std::stod(tokens[8]);
+            if (!toDouble(tokens[8], data.courseOverGround)) return false;
             data.heading = data.courseOverGround; // Approximation
         }
 
         // Date & Time
         if (!tokens[1].empty() && !tokens[9].empty() && tokens[1].length() >= 6 && tokens[9].length() == 6) {
             std::tm tm = {};
-            try {
-                // Time: HHMMSS
-                tm.tm_hour = std::stoi(tokens[1].substr(0, 2));
-                tm.tm_min = std::stoi(tokens[1].substr(2, 2));
-                tm.tm_sec = std::stoi(tokens[1].substr(4, 2));
-                
-                // Date: DDMMYY
-                tm.tm_mday = std::stoi(tokens[9].substr(0, 2));
-                tm.tm_mon = std::stoi(tokens[9].substr(2, 2)) - 1; // 0-11
-                int year = std::stoi(tokens[9].substr(4, 2));
+            int month = 0;
+            int year = 0;
+            // Time: HHMMSS, Date: DDMMYY. Malformed values are ignored.
+            if (toInt(tokens[1].substr(0, 2), tm.tm_hour) &&
+                toInt(tokens[1].substr(2, 2), tm.tm_min) &&
+                toInt(tokens[1].substr(4, 2), tm.tm_sec) &&
+                toInt(tokens[9].substr(0, 2), tm.tm_mday) &&
+                toInt(tokens[9].substr(2, 2), month) &&
+                toInt(tokens[9].substr(4, 2), year)) {
+                tm.tm_mon = month - 1; // 0-11
                 tm.tm_year = (year < 80 ? 2000 + year : 1900 + year) - 1900; // Years since 1900
 
                 time_t time = timegm(&tm); // Use timegm for UTC
                 if (time != -1) {
                     data.timestamp = std::chrono::system_clock::from_time_t(time);
                 }
-            } catch (...) {
-                // Ignore parsing errors
             }
         }
     }
+    return true;
 }
 
-void NmeaParser::parseGGA(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseGGA(const NmeaFields& tokens, Core::NavData& data) {
     // $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47
     // 0: ID
     // 1: Time
@@ -184,34 +315,29 @@ void NmeaParser::parseGGA(const std::vector<std::string>& tokens, Core::NavData&
     // 9: Altitude
     // 10: Altitude Unit (M)
     
-    if (tokens.size() < 10) return;
+    if (tokens.size() < 10) return true;
 
     // Quality indicator: 0 = Invalid, 1 = GPS fix, 2 = DGPS fix, etc.
-    try {
-        int quality = std::stoi(tokens[6]);
-        data.isGpsValid = (quality > 0);
-    } catch (...) {
-        data.isGpsValid = false;
-    }
+    int quality = 0;
+    data.isGpsValid = toInt(tokens[6], quality) && quality > 0;
     data.hasPosition = true;
 
     // Position
     if (!tokens[2].empty() && !tokens[3].empty()) {
-        data.latitude = convertNmeaCoord(tokens[2], tokens[3]);
+        if (!convertNmeaCoord(tokens[2], tokens[3], data.latitude)) return false;
     }
     if (!tokens[4].empty() && !tokens[5].empty()) {
-        data.longitude = convertNmeaCoord(tokens[4], tokens[5]);
+        if (!convertNmeaCoord(tokens[4], tokens[5], data.longitude)) return false;
     }
     
-    // Altitude
+    // Altitude (ignored if malformed)
     if (!tokens[9].empty()) {
-        try {
-            data.altitude = std::stod(tokens[9]);
-        } catch (...) {}
+        toDouble(tokens[9], data.altitude);
     }
+    return true;
 }
 
-void NmeaParser::parseMWV(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseMWV(const NmeaFields& tokens, Core::NavData& data) {
     // $IIMWV,084.0,R,10.4,N,A*04
     // 1: Wind Angle
     // 2: Reference (R/T)
@@ -219,77 +345,84 @@ void NmeaParser::parseMWV(const std::vector<std::string>& tokens, Core::NavData&
     // 4: Unit (N/K/M)
     // 5: Status
     
-    if (tokens.size() < 6) return;
+    if (tokens.size() < 6) return true;
     
     if (tokens[5] == "A") {
-        if (!tokens[1].empty()) data.windAngle = std::stod(tokens[1]);
-        if (!tokens[3].empty()) data.windSpeed = std::stod(tokens[3]);
+        if (!tokens[1].empty() && !toDouble(tokens[1], data.windAngle)) return false;
+        if (!tokens[3].empty() && !toDouble(tokens[3], data.windSpeed)) return false;
         data.hasWind = true;
     }
+    return true;
 }
 
-void NmeaParser::parseDPT(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseDPT(const NmeaFields& tokens, Core::NavData& data) {
     // $IIDPT,depth,offset*cs
     // 1: Depth relative to transducer
     // 2: Offset from transducer
     
-    if (tokens.size() < 2) return;
+    if (tokens.size() < 2) return true;
     
     if (!tokens[1].empty()) {
-        data.depth = std::stod(tokens[1]);
+        if (!toDouble(tokens[1], data.depth)) return false;
         
         // Apply offset if present
         if (tokens.size() > 2 && !tokens[2].empty()) {
-            data.depth += std::stod(tokens[2]);
+            double offset;
+            if (!toDouble(tokens[2], offset)) return false;
+            data.depth += offset;
         }
         
         data.hasDepth = true;
     }
+    return true;
 }
 
-void NmeaParser::parseMTW(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseMTW(const NmeaFields& tokens, Core::NavData& data) {
     // $IIMTW,11.0,C*cs
     // 1: Temperature
     // 2: Unit (C)
     
-    if (tokens.size() < 2) return;
+    if (tokens.size() < 2) return true;
     
     if (!tokens[1].empty()) {
-        data.waterTemperature = std::stod(tokens[1]);
+        if (!toDouble(tokens[1], data.waterTemperature)) return false;
         data.hasWaterTemperature = true;
     }
+    return true;
 }
 
-void NmeaParser::parseVHW(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseVHW(const NmeaFields& tokens, Core::NavData& data) {
     // $IIVHW,degT,T,degM,M,knots,N,kmh,K*cs
     // 1: Heading True
     // 3: Heading Magnetic
     // 5: Speed Knots
     // 7: Speed Kmh
     
-    if (tokens.size() < 6) return;
+    if (tokens.size() < 6) return true;
     
     if (!tokens[1].empty()) {
-        data.heading = std::stod(tokens[1]);
+        if (!toDouble(tokens[1], data.heading)) return false;
         data.hasHeading = true;
     }
     
     if (!tokens[5].empty()) {
-        data.speedThroughWater = std::stod(tokens[5]);
+        if (!toDouble(tokens[5], data.speedThroughWater)) return false;
         data.hasWaterSpeed = true;
     }
+    return true;
 }
 
-void NmeaParser::parseHDT(const std::vector<std::string>& tokens, Core::NavData& data) {
+bool NmeaParser::parseHDT(const NmeaFields& tokens, Core::NavData& data) {
     // $IIHDT,heading,T*cs
     // 1: Heading
     
-    if (tokens.size() < 2) return;
+    if (tokens.size() < 2) return true;
     
     if (!tokens[1].empty()) {
-        data.heading = std::stod(tokens[1]);
+        if (!toDouble(tokens[1], data.heading)) return false;
         data.hasHeading = true;
     }
+    return true;
 }
 
 } // namespace Parsers
@@ -1,29 +1,65 @@
 #pragma once
 
 #include "core/NavData.hpp"
+#include "parsers/NmeaFields.hpp"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Parsers {
 
 class NmeaParser {
 public:
+    // Handler for one sentence formatter (e.g. "RMC"), whatever the talker ID.
+    // Returns false if the sentence is malformed.
+    using SentenceHandler = bool (*)(const NmeaFields& fields, Core::NavData& data);
+
+    struct SentenceStats {
+        std::string formatter;
+        uint64_t hits = 0;     // Sentences dispatched to the handler
+        uint64_t failures = 0; // Sentences the handler rejected
+    };
+
     // Parses a raw NMEA sentence and updates the provided NavData structure.
     // Returns true if parsing was successful.
-    static bool parse(const std::string& sentence, Core::NavData& data);
+    // Works in place on the input buffer: no allocations and no exceptions per sentence.
+    // Bulk callers parsing on many threads at once pass countStats = false: the shared
+    // per-formatter counters would otherwise bounce between cores.
+    static bool parse(std::string_view sentence, Core::NavData& data, bool countStats = true);
+    static bool parse(const std::string& sentence, Core::NavData& data) {
+        return parse(std::string_view(sentence), data);
+    }
+
+    static bool verifyChecksum(std::string_view sentence);
+
+    // Runtime registration, safe while other threads are parsing.
+    // The formatter must be three uppercase letters. An existing handler
+    // (built-in or not) is replaced. Returns false if the formatter is invalid
+    // or the table is full.
+    static bool registerHandler(std::string_view formatter, SentenceHandler handler);
+    // Restores the built-in handler of the formatter, if any. Returns once no thread runs
+    // the removed handler anymore: its code can then be unloaded.
+    static void unregisterHandler(std::string_view formatter);
+
+    // Per-formatter counters, to see which sentences dominate the traffic.
+    static std::vector<SentenceStats> getSentenceStats();
+    static uint64_t getUnhandledCount();
+    static void resetStats();
 
 private:
-    static std::vector<std::string> split(const std::string& s, char delimiter);
-    static bool verifyChecksum(const std::string& sentence);
-    
-    // Parsers for specific sentences
-    static void parseRMC(const std::vector<std::string>& tokens, Core::NavData& data);
-    static void parseGGA(const std::vector<std::string>& tokens, Core::NavData& data);
-    static void parseMWV(const std::vector<std::string>& tokens, Core::NavData& data);
-    static void parseDPT(const std::vector<std::string>& tokens, Core::NavData& data);
-    static void parseMTW(const std::vector<std::string>& tokens, Core::NavData& data);
-    static void parseVHW(const std::vector<std::string>& tokens, Core::NavData& data);
-    static void parseHDT(const std::vector<std::string>& tokens, Core::NavData& data);
+    // Formatter -> handler dispatch table, defined in NmeaParser.cpp
+    class SentenceTable;
+    static SentenceTable& table();
+
+    // Parsers for specific sentences. They return false on malformed numeric fields.
+    static bool parseRMC(const NmeaFields& tokens, Core::NavData& data);
+    static bool parseGGA(const NmeaFields& tokens, Core::NavData& data);
+    static bool parseMWV(const NmeaFields& tokens, Core::NavData& data);
+    static bool parseDPT(const NmeaFields& tokens, Core::NavData& data);
+    static bool parseMTW(const NmeaFields& tokens, Core::NavData& data);
+    static bool parseVHW(const NmeaFields& tokens, Core::NavData& data);
+    static bool parseHDT(const NmeaFields& tokens, Core::NavData& data);
 };
 
 } // namespace Parsers
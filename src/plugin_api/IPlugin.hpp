@@ -2,6 +2,7 @@
 
 #include "imgui.h"
 #include "../core/NavData.hpp"
+#include "../parsers/NmeaFields.hpp"
 #include <string>
 
 #ifdef _WIN32
@@ -12,8 +13,19 @@
 
 namespace PluginApi {
 
+// NMEA sentence handler provided by a plugin (see Parsers::NmeaParser::registerHandler)
+typedef bool (*SentenceHandlerFunc)(const Parsers::NmeaFields& fields, Core::NavData& data);
+typedef bool (*RegisterSentenceHandlerFunc)(const char* formatter, SentenceHandlerFunc handler);
+typedef void (*UnregisterSentenceHandlerFunc)(const char* formatter);
+
 struct PluginContext {
     ImGuiContext* imguiContext;
+
+    // Adds a parser for a sentence formatter (e.g. "VTG"). Handlers live in the
+    // plugin's code, so they must be unregistered in shutdown(). Unregistering a
+    // built-in formatter (e.g. "RMC") restores the built-in parser.
+    RegisterSentenceHandlerFunc registerSentenceHandler = nullptr;
+    UnregisterSentenceHandlerFunc unregisterSentenceHandler = nullptr;
 };
 
 class IPlugin {
@@ -1,5 +1,6 @@
 #include "ConfigManager.hpp"
 #include "tinyxml2.h"
+#include <algorithm>
 #include <iostream>
 
 using namespace tinyxml2;
@@ -44,6 +45,26 @@ void ConfigManager::load(const std::string& filename) {
                     config.type = App::SourceType::Udp;
                     int port = sourceElem->IntAttribute("port");
                     if (port > 0) config.port = port;
+                    const char* group = sourceElem->Attribute("multicastGroup");
+                    const char* interfaceAddress = sourceElem->Attribute("interface");
+                    const char* sourceFilter = sourceElem->Attribute("sourceFilter");
+                    if (group) config.multicastGroup = group;
+                    if (interfaceAddress) config.interfaceAddress = interfaceAddress;
+                    if (sourceFilter) config.sourceFilter = sourceFilter;
+                    config.sharedPort = sourceElem->BoolAttribute("sharedPort", config.sharedPort);
+                    config.udpReceivers = sourceElem->IntAttribute("receivers", config.udpReceivers);
+                } else if (type == "TCPClient") {
+                    config.type = App::SourceType::TcpClient;
+                    const char* addr = sourceElem->Attribute("address");
+                    int port = sourceElem->IntAttribute("port");
+                    if (addr) config.address = addr;
+                    if (port > 0) config.port = port;
+                } else if (type == "Replay") {
+                    config.type = App::SourceType::Replay;
+                    const char* path = sourceElem->Attribute("path");
+                    if (path) config.replayPath = path;
+                    config.replaySpeed = std::max(sourceElem->DoubleAttribute("speed", config.replaySpeed), 0.0);
+                    config.replayLoop = sourceElem->BoolAttribute("loop", config.replayLoop);
                 }
             }
 
@@ -80,6 +101,14 @@ void ConfigManager::load(const std::string& filename) {
                     int port = outputElem->IntAttribute("port");
                     if (addr) config.address = addr;
                     if (port > 0) config.port = port;
+                    config.coalesce = outputElem->BoolAttribute("coalesce", config.coalesce);
+                    config.maxDatagramSize = outputElem->IntAttribute("maxDatagramSize", config.maxDatagramSize);
+                    config.flushDelayMs = outputElem->IntAttribute("flushDelayMs", config.flushDelayMs);
+                } else if (type == "TCPServer") {
+                    config.type = App::OutputType::TcpServer;
+                    int port = outputElem->IntAttribute("port");
+                    if (port > 0) config.port = port;
+                    config.maxClients = outputElem->IntAttribute("maxClients", config.maxClients);
                 }
             }
 
@@ -97,6 +126,25 @@ void ConfigManager::load(const std::string& filename) {
                 }
             }
 
+            XMLElement* filtersElem = outputElem->FirstChildElement("Filters");
+            if (filtersElem) {
+                config.aisRangeNm = filtersElem->DoubleAttribute("aisRangeNm", 0.0);
+
+                for (XMLElement* elem = filtersElem->FirstChildElement("Allow"); elem; elem = elem->NextSiblingElement("Allow")) {
+                    if (elem->GetText()) config.allowSentences.push_back(elem->GetText());
+                }
+                for (XMLElement* elem = filtersElem->FirstChildElement("Deny"); elem; elem = elem->NextSiblingElement("Deny")) {
+                    if (elem->GetText()) config.denySentences.push_back(elem->GetText());
+                }
+                for (XMLElement* elem = filtersElem->FirstChildElement("RateLimit"); elem; elem = elem->NextSiblingElement("RateLimit")) {
+                    App::SentenceRateLimit limit;
+                    const char* sentence = elem->Attribute("sentence");
+                    if (sentence) limit.sentence = sentence;
+                    limit.intervalMs = elem->IntAttribute("intervalMs", limit.intervalMs);
+                    config.rateLimits.push_back(limit);
+                }
+            }
+
             _outputs.push_back(config);
             outputElem = outputElem->NextSiblingElement("Output");
         }
@@ -108,6 +156,15 @@ void ConfigManager::load(const std::string& filename) {
         _displayConfig.theme = displayElem->IntAttribute("theme", 0);
     }
 
+    XMLElement* recordingElem = root->FirstChildElement("Recording");
+    if (recordingElem) {
+        _recordingConfig.enabled = recordingElem->BoolAttribute("enabled", false);
+        const char* directory = recordingElem->Attribute("directory");
+        if (directory) _recordingConfig.directory = directory;
+        _recordingConfig.segmentSizeMB = recordingElem->IntAttribute("segmentSizeMB", _recordingConfig.segmentSizeMB);
+        _recordingConfig.segmentMinutes = recordingElem->IntAttribute("segmentMinutes", _recordingConfig.segmentMinutes);
+    }
+
     XMLElement* simElem = root->FirstChildElement("Simulator");
     if (simElem) {
         _simulatorConfig.enableGps = simElem->BoolAttribute("enableGps", true);
@@ -137,6 +194,13 @@ void ConfigManager::save(const std::string& filename) {
     displayElem->SetAttribute("theme", _displayConfig.theme);
     root->InsertEndChild(displayElem);
 
+    XMLElement* recordingElem = doc.NewElement("Recording");
+    recordingElem->SetAttribute("enabled", _recordingConfig.enabled);
+    recordingElem->SetAttribute("directory", _recordingConfig.directory.c_str());
+    recordingElem->SetAttribute("segmentSizeMB", _recordingConfig.segmentSizeMB);
+    recordingElem->SetAttribute("segmentMinutes", _recordingConfig.segmentMinutes);
+    root->InsertEndChild(recordingElem);
+
     XMLElement* simElem = doc.NewElement("Simulator");
     simElem->SetAttribute("enableGps", _simulatorConfig.enableGps);
     simElem->SetAttribute("enableWind", _simulatorConfig.enableWind);
@@ -168,6 +232,20 @@ void ConfigManager::save(const std::string& filename) {
         } else if (source.type == App::SourceType::Udp) {
             sourceElem->SetAttribute("type", "UDP");
             sourceElem->SetAttribute("port", source.port);
+            sourceElem->SetAttribute("multicastGroup", source.multicastGroup.c_str());
+            sourceElem->SetAttribute("interface", source.interfaceAddress.c_str());
+            sourceElem->SetAttribute("sourceFilter", source.sourceFilter.c_str());
+            sourceElem->SetAttribute("sharedPort", source.sharedPort);
+            sourceElem->SetAttribute("receivers", source.udpReceivers);
+        } else if (source.type == App::SourceType::TcpClient) {
+            sourceElem->SetAttribute("type", "TCPClient");
+            sourceElem->SetAttribute("address", source.address.c_str());
+            sourceElem->SetAttribute("port", source.port);
+        } else if (source.type == App::SourceType::Replay) {
+            sourceElem->SetAttribute("type", "Replay");
+            sourceElem->SetAttribute("path", source.replayPath.c_str());
+            sourceElem->SetAttribute("speed", source.replaySpeed);
+            sourceElem->SetAttribute("loop", source.replayLoop);
         }
 
         sourcesElem->InsertEndChild(sourceElem);
@@ -190,6 +268,13 @@ void ConfigManager::save(const std::string& filename) {
             outputElem->SetAttribute("type", "UDP");
             outputElem->SetAttribute("address", output.address.c_str());
             outputElem->SetAttribute("port", output.port);
+            outputElem->SetAttribute("coalesce", output.coalesce);
+            outputElem->SetAttribute("maxDatagramSize", output.maxDatagramSize);
+            outputElem->SetAttribute("flushDelayMs", output.flushDelayMs);
+        } else if (output.type == App::OutputType::TcpServer) {
+            outputElem->SetAttribute("type", "TCPServer");
+            outputElem->SetAttribute("port", output.port);
+            outputElem->SetAttribute("maxClients", output.maxClients);
         }
 
         outputElem->SetAttribute("multiplexAll", output.multiplexAll);
@@ -202,6 +287,26 @@ void ConfigManager::save(const std::string& filename) {
             sourceIdsElem->InsertEndChild(idElem);
         }
 
+        XMLElement* filtersElem = doc.NewElement("Filters");
+        outputElem->InsertEndChild(filtersElem);
+        filtersElem->SetAttribute("aisRangeNm", output.aisRangeNm);
+        for (const auto& sentence : output.allowSentences) {
+            XMLElement* elem = doc.NewElement("Allow");
+            elem->SetText(sentence.c_str());
+            filtersElem->InsertEndChild(elem);
+        }
+        for (const auto& sentence : output.denySentences) {
+            XMLElement* elem = doc.NewElement("Deny");
+            elem->SetText(sentence.c_str());
+            filtersElem->InsertEndChild(elem);
+        }
+        for (const auto& limit : output.rateLimits) {
+            XMLElement* elem = doc.NewElement("RateLimit");
+            elem->SetAttribute("sentence", limit.sentence.c_str());
+            elem->SetAttribute("intervalMs", limit.intervalMs);
+            filtersElem->InsertEndChild(elem);
+        }
+
         outputsElem->InsertEndChild(outputElem);
     }
 
@@ -30,12 +30,16 @@ public:
     Simulator::SimulatorConfig getSimulatorConfig() const { return _simulatorConfig; }
     void setSimulatorConfig(const Simulator::SimulatorConfig& config) { _simulatorConfig = config; }
 
+    App::RecordingConfig getRecordingConfig() const { return _recordingConfig; }
+    void setRecordingConfig(const App::RecordingConfig& config) { _recordingConfig = config; }
+
 private:
     ConfigManager() = default;
     std::vector<App::DataSourceConfig> _sources;
     std::vector<App::DataOutputConfig> _outputs;
     App::DisplayConfig _displayConfig;
     Simulator::SimulatorConfig _simulatorConfig;
+    App::RecordingConfig _recordingConfig;
 };
 
 } // namespace Utils
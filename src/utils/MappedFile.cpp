@@ -0,0 +1,107 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Utils {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) : _path(path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open " + path);
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot read the size of " + path);
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+
+    if (_size > 0) {
+        _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping) _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    CloseHandle(file); // The mapping keeps the file open
+
+    if (_size > 0 && !_data) {
+        unmap();
+        throw std::runtime_error("Cannot map " + path);
+    }
+}
+
+void MappedFile::unmap() {
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(_mapping);
+    _data = nullptr;
+    _mapping = nullptr;
+    _size = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) : _path(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read the size of " + path);
+    }
+    _size = static_cast<size_t>(info.st_size);
+
+    if (_size > 0) {
+        void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        _data = static_cast<const char*>(data);
+        ::madvise(data, _size, MADV_SEQUENTIAL); // Read ahead, drop pages behind
+    }
+    ::close(fd); // The mapping keeps the file open
+}
+
+void MappedFile::unmap() {
+    if (_data) ::munmap(const_cast<char*>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _path(std::move(other._path)), _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)) {
+#ifdef _WIN32
+    _mapping = std::exchange(other._mapping, nullptr);
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        _path = std::move(other._path);
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#ifdef _WIN32
+        _mapping = std::exchange(other._mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+} // namespace Utils
@@ -0,0 +1,325 @@
+#include "ReplayLog.hpp"
+#include "core/RecordingFormat.hpp"
+#include "parsers/NmeaFields.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace Utils {
+
+namespace Recording = Core::Recording;
+
+ReplayLog::ReplayLog(const std::string& path) {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        std::vector<std::string> segments;
+        for (const auto& item : fs::directory_iterator(path, ec)) {
+            if (item.is_regular_file() && item.path().extension() == Recording::Extension) {
+                segments.push_back(item.path().string());
+            }
+        }
+        if (segments.empty()) throw std::runtime_error("No recording in " + path);
+        // Segment names sort by date, time and sequence
+        std::sort(segments.begin(), segments.end());
+        for (const auto& segment : segments) openRecording(segment);
+    } else {
+        MappedFile probe(path);
+        if (probe.size() >= sizeof(Recording::SegmentHeader) &&
+            std::memcmp(probe.data(), Recording::SegmentMagic, sizeof(Recording::SegmentMagic)) == 0) {
+            openRecording(path);
+        } else {
+            openText(path);
+        }
+    }
+
+    if (_index.empty()) throw std::runtime_error("No sentences in " + path);
+
+    std::stable_sort(_index.begin(), _index.end(),
+                     [](const IndexPoint& a, const IndexPoint& b) { return a.timeNs < b.timeNs; });
+    _startNs = _index.front().timeNs;
+}
+
+void ReplayLog::openRecording(const std::string& path) {
+    _format = Format::Recording;
+    _wallClock = true;
+
+    Chunk chunk;
+    chunk.file = MappedFile(path);
+    const char* data = chunk.file.data();
+    const uint64_t size = chunk.file.size();
+
+    Recording::SegmentHeader header;
+    if (size < sizeof(header)) return;
+    std::memcpy(&header, data, sizeof(header));
+    if (!Recording::hasMagic(header.magic, Recording::SegmentMagic) || header.version != Recording::Version ||
+        header.headerSize < sizeof(header) || header.headerSize > size) {
+        throw std::runtime_error("Not a supported recording: " + path);
+    }
+    chunk.begin = header.headerSize;
+    chunk.clockOffsetNs = header.wallClockNs - header.monotonicNs;
+
+    const uint32_t chunkIndex = static_cast<uint32_t>(_chunks.size());
+    std::vector<IndexPoint> points;
+    int64_t firstNs = 0;
+    int64_t lastNs = 0;
+    bool hasSentences = false;
+
+    // Closed segment: take its index
+    Recording::SegmentTrailer trailer;
+    bool closed = false;
+    if (size >= chunk.begin + sizeof(trailer)) {
+        std::memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+        // Checked before use: a damaged or foreign trailer must not point outside the file
+        closed = Recording::hasMagic(trailer.magic, Recording::TrailerMagic) && trailer.indexOffset >= chunk.begin &&
+                 trailer.indexOffset <= size - sizeof(trailer) &&
+                 trailer.indexCount <= (size - sizeof(trailer) - trailer.indexOffset) / sizeof(Recording::IndexEntry);
+    }
+
+    if (closed) {
+        chunk.end = trailer.indexOffset;
+        hasSentences = trailer.recordCount > 0;
+        firstNs = trailer.firstTimestampNs;
+        lastNs = trailer.lastTimestampNs;
+        for (uint64_t i = 0; i < trailer.indexCount; ++i) {
+            Recording::IndexEntry entry;
+            std::memcpy(&entry, data + trailer.indexOffset + i * sizeof(entry), sizeof(entry));
+            if (entry.offset < chunk.begin || entry.offset >= chunk.end) continue;
+            points.push_back(IndexPoint{entry.timestampNs, chunkIndex, entry.offset});
+        }
+    } else {
+        // Unfinished segment: scan up to its last complete record
+        int64_t nextIndexNs = 0;
+        uint64_t offset = chunk.begin;
+        Recording::RecordHeader record;
+        while (offset + sizeof(record) <= size) {
+            std::memcpy(&record, data + offset, sizeof(record));
+            if (record.length > size - offset - sizeof(record)) break;
+            if (record.type == static_cast<uint8_t>(Recording::RecordType::Sentence)) {
+                if (!hasSentences) firstNs = record.timestampNs;
+                if (!hasSentences || record.timestampNs >= nextIndexNs) {
+                    points.push_back(IndexPoint{record.timestampNs, chunkIndex, offset});
+                    nextIndexNs = record.timestampNs + IndexIntervalNs;
+                }
+                hasSentences = true;
+                lastNs = record.timestampNs;
+            }
+            offset += sizeof(record) + record.length;
+        }
+        chunk.end = offset;
+    }
+
+    if (!hasSentences) return;
+
+    // Replay of a segment starts at its first record, so its source names are known
+    if (points.empty() || points.front().offset != chunk.begin) {
+        points.insert(points.begin(), IndexPoint{firstNs, chunkIndex, chunk.begin});
+    }
+
+    for (auto& point : points) {
+        point.timeNs += chunk.clockOffsetNs;
+        _index.push_back(point);
+    }
+    _endNs = std::max(_endNs, lastNs + chunk.clockOffsetNs);
+    _chunks.push_back(std::move(chunk));
+}
+
+void ReplayLog::openText(const std::string& path) {
+    _format = Format::Text;
+
+    Chunk chunk;
+    chunk.file = MappedFile(path);
+    chunk.end = chunk.file.size();
+    const std::string_view text = chunk.file.view();
+
+    // First timed sentence gives the start of the log
+    int64_t timeNs = -1;
+    for (size_t pos = 0; pos < text.size() && timeNs < 0;) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        int64_t timeOfDay;
+        if (sentenceTime(lineSentence(text.substr(pos, eol - pos)), timeOfDay)) timeNs = timeOfDay;
+        pos = eol + 1;
+    }
+    _untimed = timeNs < 0;
+    if (_untimed) timeNs = 0;
+
+    int64_t nextIndexNs = timeNs;
+    bool hasSentences = false;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view sentence = lineSentence(text.substr(pos, eol - pos));
+
+        if (!sentence.empty()) {
+            int64_t timeOfDay;
+            if (!_untimed && sentenceTime(sentence, timeOfDay)) timeNs = followTime(timeNs, timeOfDay);
+            // Index point: this line and its time, as the cursor will see them when starting here
+            if (!hasSentences || timeNs >= nextIndexNs) {
+                _index.push_back(IndexPoint{timeNs, 0, pos});
+                nextIndexNs = timeNs + IndexIntervalNs;
+            }
+            hasSentences = true;
+            _endNs = timeNs;
+            if (_untimed) timeNs += UntimedStepNs;
+        }
+        pos = eol + 1;
+    }
+
+    if (hasSentences) _chunks.push_back(std::move(chunk));
+}
+
+// Prefixes (log timestamps, tags) before the sentence are dropped
+std::string_view ReplayLog::lineSentence(std::string_view line) {
+    size_t start = line.find_first_of("$!");
+    if (start == std::string_view::npos) return {};
+    line.remove_prefix(start);
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.remove_suffix(1);
+    return line;
+}
+
+// Small steps back (out of order talkers) are held at 'previousNs'
+int64_t ReplayLog::followTime(int64_t previousNs, int64_t timeOfDayNs) {
+    int64_t day = previousNs / DayNs;
+    int64_t t = day * DayNs + timeOfDayNs;
+    if (t < previousNs - DayNs / 2) t += DayNs;
+    return std::max(t, previousNs);
+}
+
+bool ReplayLog::sentenceTime(std::string_view sentence, int64_t& timeOfDayNs) {
+    if (sentence.size() < 7 || sentence.front() != '$') return false;
+
+    size_t star = sentence.find('*');
+    Parsers::NmeaFields fields;
+    fields.tokenize(sentence.substr(1, star == std::string_view::npos ? std::string_view::npos : star - 1));
+
+    std::string_view type = fields[0].size() >= 5 ? fields[0].substr(fields[0].size() - 3) : std::string_view{};
+    std::string_view time;
+    if (type == "RMC" || type == "GGA" || type == "GNS" || type == "ZDA") {
+        time = fields[1];
+    } else if (type == "GLL") {
+        time = fields[5];
+    } else {
+        return false;
+    }
+
+    if (time.size() < 6) return false;
+    int hh, mm;
+    double ss;
+    if (!Parsers::toInt(time.substr(0, 2), hh) || !Parsers::toInt(time.substr(2, 2), mm) ||
+        !Parsers::toDouble(time.substr(4), ss)) {
+        return false;
+    }
+    if (hh < 0 || hh > 23 || mm < 0 || mm > 59 || ss < 0.0 || ss >= 61.0) return false;
+
+    timeOfDayNs = (hh * 3600LL + mm * 60LL) * 1000000000LL + static_cast<int64_t>(ss * 1e9);
+    return true;
+}
+
+ReplayLog::Cursor::Cursor(const ReplayLog& log) : _log(log) {
+    seek(log._startNs);
+}
+
+void ReplayLog::Cursor::moveTo(size_t chunk, uint64_t offset, int64_t timeNs) {
+    _chunk = chunk;
+    _offset = offset;
+    _timeNs = timeNs;
+    _sources.fill(std::string_view{});
+}
+
+void ReplayLog::Cursor::seek(int64_t timeNs) {
+    const auto& index = _log._index;
+    if (index.empty()) return;
+
+    auto it = std::upper_bound(index.begin(), index.end(), timeNs,
+                               [](int64_t t, const IndexPoint& point) { return t < point.timeNs; });
+    if (it != index.begin()) {
+        --it;
+        // First of equal points: a segment start comes before the index entry of its first sentence
+        it = std::lower_bound(index.begin(), it, it->timeNs,
+                              [](const IndexPoint& point, int64_t t) { return point.timeNs < t; });
+    }
+    moveTo(it->chunk, it->offset, it->timeNs);
+
+    // At most one index interval to skip
+    while (true) {
+        size_t chunk = _chunk;
+        uint64_t offset = _offset;
+        int64_t previousNs = _timeNs;
+        Entry entry;
+        if (!next(entry)) return;
+        if (entry.timeNs >= timeNs) {
+            // Sources named on the way stay known
+            _chunk = chunk;
+            _offset = offset;
+            _timeNs = previousNs;
+            return;
+        }
+    }
+}
+
+bool ReplayLog::Cursor::next(Entry& entry) {
+    return _log._format == Format::Recording ? nextRecord(entry) : nextLine(entry);
+}
+
+bool ReplayLog::Cursor::nextRecord(Entry& entry) {
+    while (_chunk < _log._chunks.size()) {
+        const Chunk& chunk = _log._chunks[_chunk];
+        Recording::RecordHeader record;
+        bool complete = _offset + sizeof(record) <= chunk.end;
+        if (complete) {
+            std::memcpy(&record, chunk.file.data() + _offset, sizeof(record));
+            // Records of a closed segment are not checked when opening: a bad length ends the chunk
+            complete = record.length <= chunk.end - _offset - sizeof(record);
+        }
+        if (!complete) {
+            if (++_chunk < _log._chunks.size()) moveTo(_chunk, _log._chunks[_chunk].begin, _timeNs);
+            continue;
+        }
+        std::string_view payload(chunk.file.data() + _offset + sizeof(record), record.length);
+        _offset += sizeof(record) + record.length;
+
+        if (record.type == static_cast<uint8_t>(Recording::RecordType::SourceName)) {
+            if (record.source < _sources.size()) _sources[record.source] = payload;
+            continue;
+        }
+        if (record.type != static_cast<uint8_t>(Recording::RecordType::Sentence)) continue;
+
+        entry.timeNs = record.timestampNs + chunk.clockOffsetNs;
+        entry.sentence = payload;
+        entry.source = record.source < _sources.size() ? _sources[record.source] : std::string_view{};
+        _timeNs = entry.timeNs;
+        return true;
+    }
+    return false;
+}
+
+bool ReplayLog::Cursor::nextLine(Entry& entry) {
+    if (_chunk >= _log._chunks.size()) return false;
+    const std::string_view text = _log._chunks[_chunk].file.view();
+
+    while (_offset < text.size()) {
+        size_t eol = text.find('\n', _offset);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view sentence = lineSentence(text.substr(_offset, eol - _offset));
+        _offset = eol + 1;
+        if (sentence.empty()) continue;
+
+        int64_t timeOfDay;
+        if (_log._untimed) {
+            entry.timeNs = _timeNs;
+            _timeNs += UntimedStepNs;
+        } else {
+            if (sentenceTime(sentence, timeOfDay)) _timeNs = followTime(_timeNs, timeOfDay);
+            entry.timeNs = _timeNs;
+        }
+        entry.sentence = sentence;
+        entry.source = {};
+        return true;
+    }
+    return false;
+}
+
+} // namespace Utils
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "utils/MappedFile.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Utils {
+
+// Read-only, memory-mapped view of a recorded log, for replay and offline processing.
+//
+// Accepts a recording directory or segment (Core::Recording, ".nvr"), or a plain NMEA text
+// log (one sentence per line). Every file is mapped, nothing is copied.
+//
+// Entries are on a single time line in nanoseconds: wall clock for recordings, and for text
+// logs the UTC time of the sentences themselves (RMC/GGA/GLL/GNS/ZDA), counted from day 0.
+// A text log without any timed sentence is paced at 10 sentences per second.
+//
+// A sparse index (one point per IndexInterval of log time) is read from the segment
+// trailers, or built on open by scanning segments without a trailer and text logs: seeking
+// is a binary search plus a scan of at most one interval.
+class ReplayLog {
+public:
+    static constexpr int64_t IndexIntervalNs = 1000000000; // 1 s
+    static constexpr int64_t UntimedStepNs = 100000000;    // 100 ms per sentence
+    static constexpr int64_t DayNs = 86400LL * 1000000000LL;
+
+    struct Entry {
+        int64_t timeNs = 0;
+        std::string_view sentence; // Without CR/LF, points into the mapping
+        std::string_view source;   // Recorded source name, empty if unknown (text logs, after a seek)
+    };
+
+    // Throws std::runtime_error if nothing can be read from 'path'
+    explicit ReplayLog(const std::string& path);
+
+    // Text log helpers, shared with offline processing.
+    // Sentence part of a line ('$'/'!' to checksum, prefixes and CR dropped), empty if none.
+    static std::string_view lineSentence(std::string_view line);
+    // UTC time of day of RMC/GGA/GLL/GNS/ZDA sentences (hhmmss.ss field)
+    static bool sentenceTime(std::string_view sentence, int64_t& timeOfDayNs);
+    // Absolute time of a sentence read after 'previousNs', rolling over midnight
+    static int64_t followTime(int64_t previousNs, int64_t timeOfDayNs);
+
+    bool empty() const { return _index.empty(); }
+    int64_t getStartTime() const { return _startNs; }
+    int64_t getEndTime() const { return _endNs; }
+    bool hasWallClock() const { return _wallClock; } // Times are UTC since the epoch
+    size_t getFileCount() const { return _chunks.size(); }
+
+    // Sequential reader, any number of them per log
+    class Cursor {
+    public:
+        explicit Cursor(const ReplayLog& log);
+
+        // Positions on the first entry at or after 'timeNs'
+        void seek(int64_t timeNs);
+        // False at the end of the log
+        bool next(Entry& entry);
+
+    private:
+        bool nextRecord(Entry& entry);
+        bool nextLine(Entry& entry);
+        void moveTo(size_t chunk, uint64_t offset, int64_t timeNs);
+
+        const ReplayLog& _log;
+        size_t _chunk = 0;
+        uint64_t _offset = 0;
+        int64_t _timeNs = 0; // Text logs: time of the last entry
+        std::array<std::string_view, 256> _sources{}; // Recordings: names by handle, per segment (first 256)
+    };
+
+private:
+    enum class Format { Recording, Text };
+
+    struct Chunk {
+        MappedFile file;
+        uint64_t begin = 0; // First record or line
+        uint64_t end = 0;   // End of the records
+        int64_t clockOffsetNs = 0; // Recordings: steady clock -> wall clock
+    };
+
+    struct IndexPoint {
+        int64_t timeNs;
+        uint32_t chunk;
+        uint64_t offset;
+    };
+
+    void openRecording(const std::string& path);
+    void openText(const std::string& path);
+
+    Format _format = Format::Recording;
+    std::vector<Chunk> _chunks;
+    std::vector<IndexPoint> _index; // Sorted by time
+    int64_t _startNs = 0;
+    int64_t _endNs = 0;
+    bool _wallClock = false;
+    bool _untimed = false; // Text log without any timed sentence
+};
+
+} // namespace Utils